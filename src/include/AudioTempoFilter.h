@@ -0,0 +1,81 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include <libavfilter/avfilter.h>
+#include <libavutil/samplefmt.h>
+}
+
+/**
+ * ٲƵ ( libavfilter  atempo ˾)
+ * 롢Ϊͬһ/Ľ (packed) PCMȾǰƵ
+ * ʹֱ׷֡ʱ߲䡣˾ WSOLA ʽصƴӣڲỺ漸ʮݣ
+ * ʻص 1.0 Ա˾ʱɶ
+ */
+class AudioTempoFilter {
+private:
+	AVFilterGraph* m_graph = nullptr;
+	AVFilterContext* m_src = nullptr;	// abuffer
+	AVFilterContext* m_sink = nullptr;	// abuffersink
+	AVFrame* m_frame = nullptr;			// õ/֡
+
+	int m_sample_rate = 0;
+	int m_channels = 0;
+	enum AVSampleFormat m_sample_fmt = AV_SAMPLE_FMT_NONE;
+	double m_tempo = 1.0;
+	int64_t m_next_pts = 0;				// ֡ PTS (ԲΪλ)
+
+public:
+	AudioTempoFilter() = default;
+	~AudioTempoFilter();
+
+	/**
+	 * @brief  PCM ʽ abuffer -> atempo -> aformat -> abuffersink ˾ͼ
+	 * @param sampleFormat ʽ ( AV_SAMPLE_FMT_S16)
+	 * @param tempo ʼ
+	 */
+	bool init(int sampleRate, int channels, enum AVSampleFormat sampleFormat, double tempo);
+
+	/**
+	 * @brief ʱ޸ ( atempo ؽ˾ͼ)
+	 */
+	bool setTempo(double tempo);
+	double getTempo() const { return m_tempo; }
+	bool isInitialized() const { return m_graph != nullptr; }
+
+	/**
+	 * @brief һ PCM˾ǰȫ׷ӵ out ĩβ
+	 * @param nbSamples ÿĲ
+	 */
+	bool process(const uint8_t* data, int nbSamples, std::vector<uint8_t>& out);
+
+	/**
+	 * @brief ͷ˾ͼ˾лһ
+	 */
+	void close();
+
+	AudioTempoFilter(const AudioTempoFilter&) = delete;
+	AudioTempoFilter& operator=(const AudioTempoFilter&) = delete;
+};
@@ -57,6 +57,8 @@ public:
     void resume() override;
     bool isPaused() const override;
     void syncToPts(double pts) override;
+    void setPlaybackRate(double rate) override;
+    double getPlaybackRate() const override;
 
 private:
     // ڲGetters
@@ -70,7 +72,10 @@ private:
     double m_video_clock_time = 0.0;
     double m_audio_clock_time = 0.0;
 
+    // ⲿʱ = m_external_base + (ǰʱ - m_start_time) * m_playback_rate
     Uint64 m_start_time = 0;
+    double m_external_base = 0.0;
+    double m_playback_rate = 1.0;
     Uint64 m_paused_at = 0;
 
     bool m_paused = true;
@@ -0,0 +1,99 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "DecoderThreadBudget.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+// һֽ
+struct DecoderBenchmarkCase {
+	std::string label;
+	DecoderThreadConfig threading;
+	bool low_delay = false;				// ԲӳģʽĲʼ
+};
+
+// һֽõĲ
+struct DecoderBenchmarkResult {
+	std::string label;
+	bool ok = false;					// Ƿɹʼɽ
+	DecoderThreadType type = DecoderThreadType::NONE;	// ʵõ߳ģ
+	int threads = 0;					// ʵʹõ߳
+	uint64_t frames = 0;				// ֡
+	double wall_sec = 0.0;				// ȫ (ϴ) ĺʱ
+	double fps = 0.0;					// £ÿ֡
+	double first_frame_ms = -1.0;		// һȡһ֡
+	double avg_latency_ms = 0.0;		// ÿ֡Ӧİȡƽʱ
+	double p95_latency_ms = 0.0;
+	double max_latency_ms = 0.0;
+	int max_pending = 0;				// 뵫δİֵ (ڲѹ֡)
+};
+
+/**
+ * Ƶ׼ļͷһƵڴ棬Բͬ߳νͬһ
+ * ͳ (fps) ÿ֡Ľӳ (ȡӦ֡)Ⱦͬ
+ * ֻӳΪͬĻƬԴѡ߳ģͺ߳
+ */
+class DecoderBenchmark {
+private:
+	std::string m_path;
+	double m_max_seconds;				// Ƶʱ ()
+	std::vector<AVPacket*> m_packets;	// ԤƵ
+	AVCodecParameters* m_codecpar = nullptr;
+	AVRational m_time_base{ 0, 1 };
+
+public:
+	/**
+	 * @param path ýļ·
+	 * @param max_seconds ԵƵʱ ()
+	 */
+	DecoderBenchmark(const std::string& path, double max_seconds);
+	~DecoderBenchmark();
+
+	/**
+	 * @brief ļƵͷİڴ
+	 */
+	bool load();
+
+	/**
+	 * @brief һýȫԤİ
+	 */
+	DecoderBenchmarkResult run(const DecoderBenchmarkCase& test_case);
+
+	/**
+	 * @brief Ĭϵϣ̡߳Ƭ̵֡߳Ĳͬ߳Ĭӳģʽ
+	 */
+	static std::vector<DecoderBenchmarkCase> defaultCases();
+
+	/**
+	 * @brief Աʽ
+	 */
+	void printReport(const std::vector<DecoderBenchmarkResult>& results, std::ostream& out) const;
+
+	DecoderBenchmark(const DecoderBenchmark&) = delete;
+	DecoderBenchmark& operator=(const DecoderBenchmark&) = delete;
+};
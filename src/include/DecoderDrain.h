@@ -0,0 +1,40 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <functional>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/**
+ * @brief һȡʱȫ֡֡ص (Ƶ decodeAll() )
+ * ͷ AVERROR(EAGAIN) ʱȡ֡ڳռ䣬·ͬһpacket Ϊ nullptr ʱϴ
+ * @param ctx Ѵ򿪵Ľ
+ * @param packet İnullptr ʾϴ
+ * @param frame ֡ AVFrameΪʱԶ (ɵ߸úͷ)
+ * @param onFrame ÿһ֡һΣ false ʱֹͣȡ֡
+ * @param tag ־ǰ׺ "FFmpegVideoDecoder::decodeAll"
+ * @return 0ȡգAVERROR_EOFϴϣAVERROR_EXITصҪֵֹͣΪ
+ */
+int decodeAllFrames(AVCodecContext* ctx, AVPacket* packet, AVFrame** frame,
+	const std::function<bool(AVFrame* frame)>& onFrame, const char* tag);
@@ -0,0 +1,87 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <mutex>
+
+extern "C" {
+#include <libavcodec/codec_id.h>	// AVCodecID
+}
+
+// Ƶ߳ģ
+enum class DecoderThreadType {
+	AUTO,	// Ĭϲѡ (ӳģʽΪƬ)
+	NONE,	// ߳
+	FRAME,	// ̣֡߳ߣÿ̶߳໺һ֡ӳ (߳ - 1) ֡
+	SLICE	// Ƭ̣߳ӳ٣ٱȡÿ֡ slice 
+};
+
+// Ƶ߳
+struct DecoderThreadConfig {
+	DecoderThreadType type = DecoderThreadType::AUTO;
+	int thread_count = 0;	// 0 ʾֱ
+};
+
+/**
+ * Ƶ߳Ԥ㡣
+ * ÿʱ̣߳Ԥ㲻ʱֵֻʣĲ ( 1 ߳̽)رʱ黹
+ * ʵͬһʱ߳Ԥ㣬԰ CPU ̶߳໥
+ * ͬʱṩֱĬ߳ģͺ߳ñ
+ */
+class DecoderThreadBudget {
+private:
+	mutable std::mutex m_mutex;
+	int m_limit;			// Ԥ
+	int m_in_use = 0;		// ѷ߳
+
+	DecoderThreadBudget();
+
+public:
+	static DecoderThreadBudget& instance();
+
+	/**
+	 * @brief ԤޣֻӰ֮
+	 * @param threads ڽ߳ޣ<= 0 ʾ CPU 
+	 */
+	void setLimit(int threads);
+	int getLimit() const;
+	int getInUse() const;
+
+	/**
+	 * @brief ߳
+	 * @param wanted ϣʹõ߳
+	 * @return ʵʷֵõ߳ΧΪ [1, wanted]ͬ release()
+	 */
+	int acquire(int wanted);
+	void release(int threads);
+
+	/**
+	 * @brief е AUTO/0 滻ΪñֱʵĬֵ (߳ñ)
+	 * @param low_delay ӳģʽ߳ģΪ AUTO ʱʹƬ߳
+	 */
+	static DecoderThreadConfig resolve(const DecoderThreadConfig& requested, AVCodecID codec_id,
+		int width, int height, bool low_delay);
+
+	static const char* typeName(DecoderThreadType type);
+
+	DecoderThreadBudget(const DecoderThreadBudget&) = delete;
+	DecoderThreadBudget& operator=(const DecoderThreadBudget&) = delete;
+};
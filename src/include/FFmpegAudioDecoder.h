@@ -46,6 +46,7 @@ public:
     // IAudioDecoder ӿʵ
     bool init(AVCodecParameters* codecParams, AVRational timeBase, IClockManager* clockManager) override;
     int decode(AVPacket* packet, AVFrame** frame) override;
+    int decodeAll(AVPacket* packet, AVFrame** frame, const FrameCallback& onFrame) override;
     void close() override;
     void flush() override;
 
@@ -21,8 +21,13 @@
 #pragma once
 
 #include "../include/IDemuxer.h"
+#include "../include/ReadAheadIOContext.h"
+#include "../include/MappedFileIOContext.h"
+#include "../include/KeyframeIndex.h"
 #include <string>
 #include <atomic>
+#include <memory>
+#include <mutex>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -31,14 +36,45 @@ extern "C" {
 #include <libavutil/time.h>		// AV_TIME_BASE
 }
 
+// ʵʱͳ (ȡʱĿ)
+struct ReconnectStats {
+	uint64_t outages = 0;				// ж (ʼ) Ĵ
+	uint64_t attempts = 0;				// ۼԴ
+	uint64_t warm_restarts = 0;			// δ䡢ԱĻָ
+	uint64_t failures = 0;				// Ĵ
+	bool reconnecting = false;			// 
+	double last_reconnect_ms = -1.0;	// һδӿʼɹĺʱ޼¼ʱΪ -1
+	double total_outage_ms = 0.0;		// ۼʱ
+};
+
 class FFmpegDemuxer : public IDemuxer {
 private:
+	// ָ˱ܣһԣ֮ļӳʼֵηֱ
+	static constexpr int RECONNECT_INITIAL_DELAY_MS = 100;
+	static constexpr int RECONNECT_MAX_DELAY_MS = 5000;
+
 	AVFormatContext* pFormatCtx = nullptr;
 	std::string m_url;
 	int m_videoStreamIndex = -1;
 	int m_audioStreamIndex = -1;
 	std::atomic<bool> m_abort_request{ false }; // ж־
 	bool m_isLiveStream = false;
+	size_t m_readAheadBytes = 0;					// ԤС (0=)
+	std::unique_ptr<ReadAheadIOContext> m_readAhead; // ԤʱĬϵ IO 
+	bool m_useMemoryMap = false;					// ļǷʹڴӳ
+	std::unique_ptr<MappedFileIOContext> m_mappedFile; // ļӳɹʱĬϵ IO 
+	bool m_useKeyframeIndex = false;				// ǷΪȱıļάؼ֡
+	bool m_keyframeIndexActive = false;				// ǰǷ˹ؼ֡
+	KeyframeIndex m_keyframeIndex;
+	std::string m_keyframeIndexPath;				// ļ·
+	bool m_lowLatency = false;						// ʵʱǷʹõӳٴ򿪲
+	// Ľֹʱ (av_gettime_relative΢룻0=)жϻص飬ȡѷ stimeout ѡ
+	std::atomic<int64_t> m_deadline_us{ 0 };
+	int64_t m_openTimeoutUs = 5000000;				//  (̽Ϣ) ʱ
+	int64_t m_readTimeoutUs = 0;					// ʵʱζʱ (0=)
+	mutable std::mutex m_contextMutex;				//  pFormatCtx ķ滻 ()̵߳Ĳѯʹ
+	mutable std::mutex m_reconnectMutex;
+	ReconnectStats m_reconnectStats;				//  m_reconnectMutex 
 
 public:
 	FFmpegDemuxer() = default;
@@ -52,14 +88,59 @@ public:
 	void flushIO() override;
 	AVFormatContext* getFormatContext() const override;
 	int findStream(AVMediaType type) const override;
+	std::vector<int> getStreamIndices(AVMediaType type) const override;
+	bool selectStream(AVMediaType type, int streamIndex) override;
 	AVCodecParameters* getCodecParameters(int streamIndex) const override;
 	AVRational getTimeBase(int streamIndex) const override;
 	double getDuration() const override;
+	double getStartTime() const override;
 
 	bool isLiveStream() const override;
+	ReconnectResult reconnect(int max_attempts) override;
 
 	// ڴⲿ MediaPlayerж
 	void requestAbort(bool abort);
+
+	/**
+	 * @brief ų́ԤС open() ֮ǰ
+	 * @param bytes Сֽڣ0 ʾãֱʹ FFmpeg Ĭ IO
+	 */
+	void setReadAhead(size_t bytes);
+	/**
+	 * @brief ñļǷͨڴӳȡ open() ֮ǰá
+	 * ӳɹʱʹԤӳʧʱ setReadAhead ô
+	 */
+	void setMemoryMappedInput(bool enable);
+	/**
+	 * @brief ǷΪȱıļ (MPEG-TS/PS) άؼ֡ open() ֮ǰá
+	 * ڽװнرʱдýļԵ ".kfidx" ļ´δʱزڰֽλ seek
+	 */
+	void setKeyframeIndexCache(bool enable);
+	/**
+	 * @brief ʵʱ (RTSP/RTMP/UDP ) ǷԵӳٲ򿪣 open() ֮ǰá
+	 * ʱرսװڲİ (fflags nobuffer)С̽̽ʱ𲥵ȴ
+	 */
+	void setLowLatency(bool enable);
+	/**
+	 * @brief ʱޣ open() ֮ǰá
+	 * ͨжϻصΪÿβýֹʱ̣ЭЧʱش
+	 * @param open_timeout_ms ̽Ϣʱޣ0 ʾ
+	 * @param read_timeout_ms ʵʱζʱ (ղݼΪ)0 ʾޣļ
+	 */
+	void setTimeouts(int open_timeout_ms, int read_timeout_ms);
+	/**
+	 * @brief ȡͳ
+	 */
+	ReconnectStats getReconnectStats() const;
+	/**
+	 * @brief ж URL ǷΪʵʱЭ (RTSP/RTMP/UDP/RTP/SRT)
+	 */
+	static bool isRealtimeUrl(const std::string& url);
+	/**
+	 * @brief ȡԤͳ
+	 * @return ǰδԤʱ false
+	 */
+	bool getReadAheadStats(ReadAheadStats& stats) const;
 	// FFmpeg жϻصǾ̬
 	static int interruptCallback(void* opaque);
 
@@ -67,5 +148,24 @@ public:
 	FFmpegDemuxer& operator=(const FFmpegDemuxer&) = delete;
 
 private:
+	// ġ벢̽ϢɹѡĬϵƵ
+	bool openInput(const char* url);
+	// رյǰԶ IO URL 
+	void closeInput();
+	// ȽǷѴ򿪵Ľʹ
+	static bool sameCodecParameters(const AVCodecParameters* a, const AVCodecParameters* b);
+	// ڽֹʱ֮ǰĲbegin ʱ (0=)end 
+	void beginOperation(int64_t timeout_us);
+	void endOperation();
 	void findStreamsInternal();
+	// ǰѡеƵø discard ־ѡΪ AVDISCARD_DEFAULTΪ AVDISCARD_ALL
+	void applyStreamDiscard();
+	// ΪµİװԶ IO (ڴӳ > Ԥ > Ĭ IO)
+	void setupCustomIO(AVFormatContext* ctx, const char* url);
+	// ͷԶ IO AVFormatContext ͷ֮
+	void releaseCustomIO();
+	// жϵǰǷҪؼ֡Ҫʱػ
+	void initKeyframeIndex(const char* url);
+	// ĿĹؼ֡дػļ
+	void saveKeyframeIndex();
 };
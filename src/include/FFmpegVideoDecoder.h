@@ -34,8 +34,15 @@ public:
 
 	bool init(AVCodecParameters* codecParams, AVRational timeBase) override;
 	int decode(AVPacket* packet, AVFrame** frame) override;
+	int decodeAll(AVPacket* packet, AVFrame** frame, const FrameCallback& onFrame) override;
 	void close() override;
 	void flush() override;
+	void setSkipFrame(enum AVDiscard discard) override;
+	void setSkipLoopFilter(enum AVDiscard discard) override;
+	void setLowDelay(bool enable) override;
+	void setThreading(const DecoderThreadConfig& config) override;
+	int getThreadCount() const override;
+	DecoderThreadType getThreadType() const override;
 
 	int getWidth() const override;
 	int getHeight() const override;
@@ -46,5 +53,12 @@ public:
 	AVCodecID getCodecID() const override;
 
 private:
+	// 黹߳Ԥ߳
+	void releaseThreads();
+
 	AVCodecContext* m_codecContext = nullptr;
+	bool m_lowDelay = false;
+	DecoderThreadConfig m_threading;					// ߳
+	int m_threadCount = 0;								// ߳Ԥֵõ߳رʱ黹
+	DecoderThreadType m_threadType = DecoderThreadType::NONE;	// ʵõ߳ģ
 };
@@ -20,19 +20,44 @@
 
 #pragma once
 
-#include <queue>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>	// std::chrono::milliseconds
 #include <atomic>
 
+#include "QueueStats.h"
+
 extern "C" {
 #include <libavcodec/avcodec.h> // AVPacket & AVFrame
 }
 
+/**
+ * ֡ (ο ffplay  FrameQueue)
+ * λе AVFrame ڹʱһԤ䣬push ͨ ref/move_ref д룬ڼ䲻ٷ䡣
+ * ߳ pop ֮⣬ͨ peek()/peek_next() ڲӵ²鿴֡
+ * λ֮Ĳλֻ߻ʣ peek õָڵ next() ֮ǰһֱЧʹʱ
+ * next() ƹ֡ͷţһ֡ҪػȾг֡á
+ * ͨ setMemoryBudget() ڴԤģʽֽ֡ȣƳפ֡ڴ档
+ */
 class FrameQueue {
 private:
-	std::queue<AVFrame*> queue;
+	// ڲλṹ
+	struct FrameSlot {
+		AVFrame* frame = nullptr;	// Ԥ֡
+		int serial = 0;				// ֡Ĳк
+		size_t bytes = 0;			// ֡õĻֽ (ʱͳ)
+	};
+
+	// Ĭϻλ (max_queue_size Ϊ 0 ʱʹ)
+	static constexpr size_t DEFAULT_RING_CAPACITY = 16;
+
+	std::unique_ptr<FrameSlot[]> m_slots;
+	size_t m_capacity = 0;					// λ
+	size_t m_rindex = 0;					// λ (޸)
+	size_t m_windex = 0;					// дλ (޸)
+	size_t m_size = 0;						// д롢δƹĲλ ( mutex )
+
 	mutable std::mutex mutex;				// mutable constlock
 	std::condition_variable cond_consumer;	// Ϊʱߵȴ
 	std::condition_variable cond_producer;	// ʱߵȴ
@@ -40,9 +65,21 @@ private:
 	std::atomic<bool> eof_signaled{ false };	// ־
 	std::atomic<bool> m_abort_request{ false }; // ǿжϱ־
 
-	size_t max_size = 0;					// 0ʾƣ>0ʾ
+	size_t max_size = 0;					// ɻδ֡ (0=ʹĬ)
+	int m_min_serial = 0;					// ʧЧޣкСڸֵ֡Ϊɴ ( mutex )
+
+	// ڴԤ ( mutex )
+	size_t m_max_frames = 0;				// Чδ֡ (<= max_size)ڴԤ
+	size_t m_max_bytes = 0;					// פ֡ڴ (0=)
+	size_t m_min_frames = 0;				// Сȣδ֡ڸֵʱֽԼ
+	std::atomic<size_t> m_total_bytes{ 0 };	// ֡õĻֽ
+
+	QueueStats m_stats;						// ʱ (ȴʱ䡢ˮλ¡ʱ)
 
 public:
+	/**
+	 * @param max_queue_size ɻδ֡0ʾʹĬ
+	 */
 	FrameQueue(size_t max_queue_size = 0);
 	~FrameQueue();
 
@@ -50,26 +87,110 @@ public:
 	* @brief ֡β
 	* ڲΪframeһµøд洢
 	* ΪΪʱ
+	* @param serial ֡Ĳкţݰкţ invalidate()
 	* @return true - ɹfalse - ʧܣframeΪnull
 	*/
-	bool push(AVFrame* frame);
+	bool push(const AVFrame* frame, int serial = 0);
 
 	/**
-	* @brief Ӷͷȡ֡ݻõṩframe
+	* @brief ƽʽ֡β (㿽)
+	* frame еͨ av_frame_move_ref Уӻü
+	* ɹغ frame Ϊ֡AVFrame ṹ屾ԹУֱӸã
+	* ʧʱ frame ԭɵ߸ unref
+	* ÷queue->push(std::move(frame), serial);
+	*/
+	bool push(AVFrame*&& frame, int serial = 0);
+
+	/**
+	* @brief Ӷͷȡ֡ͨ av_frame_move_ref ƽṩframe
+	* ȼ peek_readable() + Ƴ + next()
 	* @param frame: ṩAVFrameָ룬ڽݡǰӦȷѷ(av_frame_alloc)
-	* ֮ǰõunrefunrefref
+	* unref֮ǰõ
+	* ʧЧкŵ invalidate() ޣ֡ᱻգ᷵ظ
 	* @param timeout_msȴʱʱ䣨룩<0:޵ȴ0>0ȴָʱ
 	* @return ɹȡframetrueʧ򷵻falseʱΪEOFΪյķã
 	*/
 	bool pop(AVFrame* frame, int timeout_ms = -1);
 
+	/**
+	* @brief ȡ֡һμȡ max_count δ֡
+	* ֻڶΪʱ timeout_ms ȴһΣȡֻһߡ
+	* @param frames ṩ max_count ѷ AVFrameԭûȱͷ
+	* @return ʵȡ֡0 ʾʱжϻΪEOF
+	*/
+	size_t pop_batch(AVFrame** frames, size_t max_count, int timeout_ms = -1);
+
+	/**
+	* @brief ȴֱδ֡ã ()
+	* ʧЧ֡ᱻա
+	* @param timeout_ms ȴʱʱ䣨룩<0:޵ȴ0>0ȴָʱ
+	* @return ǰδ֡ʱжϡΪEOFʱ nullptr
+	*/
+	AVFrame* peek_readable(int timeout_ms = -1);
+
+	/**
+	* @brief 鿴ǰδ֡ (ȴ)ǰȷ nb_remaining() > 0
+	* @param serial  (ѡ)ظ֡к
+	*/
+	AVFrame* peek(int* serial = nullptr);
+
+	/**
+	* @brief 鿴ǰδ֮֡һ֡ (ȴ)ǰȷ nb_remaining() > 1
+	*/
+	AVFrame* peek_next(int* serial = nullptr);
+
+	/**
+	* @brief ǰδ֡ʾ򱻶λǰһ֡ͷŸ֡
+	*/
+	void next();
+
+	/**
+	* @brief ڴԤģʽ
+	* Ȱ max_bytes / frame_bytes 㣬 [min_frames, max_queue_size] ڣ
+	* ˺ push δ֡ﵽȣפֽ max_bytesδ֡ min_framesʱ
+	* ʵֽ֡õĻͳƣ˷ֱ;仯ʱȻЧ
+	* @param frame_bytes ֽ֡ƣʽ av_image_get_buffer_size0 ʾδ֪
+	* @param max_bytes פ֡ڴޣֽڣ0 ʾ
+	* @param min_frames Сȣ֤ս붶
+	* @return Ķ
+	*/
+	size_t setMemoryBudget(size_t frame_bytes, size_t max_bytes, size_t min_frames);
+
+	/**
+	* @brief ȡЧȣδڴԤʱΪ max_queue_size
+	*/
+	size_t capacity() const;
+
+	/**
+	* @brief ȡ֡õĻֽ
+	*/
+	size_t getTotalBytes() const { return m_total_bytes.load(std::memory_order_relaxed); }
+
+	/**
+	* @brief ȡʱͳƿ (ˮλδ֡ͳ)ʼµˮλͳƴ
+	*/
+	QueueStatsSnapshot takeStats();
+
+	/**
+	* @brief ȡδ֡
+	*/
+	size_t nb_remaining() const;
+
 	/**
 	* @brief ȡеǰԪ
 	*/
 	size_t size() const;
 
 	/**
-	* @brief նеݰͷԴ
+	* @brief  O(1) ʹкС serial ֡ʧЧ (ʧЧ)
+	* ͷκ֡֡ pop/peek_readable ʱա
+	* ͬʱ EOF ־ѵȴ̡߳
+	*/
+	void invalidate(int serial);
+
+	/**
+	* @brief նе֡ͷԴ
+	* @warning ߳ peek õָʱõ
 	*/
 	void clear();
 
@@ -90,4 +211,50 @@ public:
 
 	FrameQueue(const FrameQueue&) = delete;
 	FrameQueue& operator=(const FrameQueue&) = delete;
+
+private:
+	/**
+	* @brief ȴֱδ֡ (ʧЧ֡)
+	* ʱѳ mutex
+	* @return δ֡ trueʱжϡΪEOFʱ false
+	*/
+	bool waitReadableLocked(std::unique_lock<std::mutex>& lock, int timeout_ms);
+
+	/**
+	* @brief ͳ֡õĻֽ
+	*/
+	static size_t frameBytes(const AVFrame* frame);
+
+	/**
+	* @brief Ƿ (βλЧȻڴԤ)
+	* ʱѳ mutex
+	*/
+	bool isFullLocked() const;
+
+	/**
+	* @brief ȴдλõĲλ
+	* ʱѳ mutex
+	* @return дĲλжϻEOFʱ nullptr
+	*/
+	FrameSlot* waitWritableLocked(std::unique_lock<std::mutex>& lock);
+
+	/**
+	* @brief дλõĲλ
+	* ʱѳ mutexʱͷ
+	* @param locked_at γ (ȴ) ʼʱ̣ͳƳʱ
+	*/
+	void publishLocked(std::unique_lock<std::mutex>& lock, QueueStats::Clock::time_point locked_at);
+
+	/**
+	* @brief λǰһ֡ (next() ڲʵ)
+	* ʱѳ mutex
+	*/
+	void advanceLocked();
+
+	/**
+	* @brief ʧЧδ֡
+	* ʱѳ mutex
+	* @return յ֡
+	*/
+	size_t purgeStaleLocked();
 };
@@ -0,0 +1,87 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+extern "C" {
+#include <libavcodec/avcodec.h>	// AVDiscard
+}
+
+/**
+ * ǰ֡ķƣƵȾ̱߳ÿһ֡Ǳʾٵ
+ * ֡ʱ߽ȼ׷Ϻ𼶷ſ̰߳ȼ
+ * AVCodecContext::skip_frame / skip_loop_filterڽ֮ǰʡעʾĹ
+ *
+ * ȼ0 룻1 ǲο֡Ļ·˲2 ǲο֡
+ *       3 ˫Ԥ֡ȫ·˲4 ֻؼ֡
+ * ſܿҪʱһηſǰĵȴʱӱȼ֮䷴񵴡
+ * onFrame() ֻȾ̵߳ãgetLevel() ̵߳á
+ */
+class FrameSkipController {
+public:
+	static constexpr int MAX_LEVEL = 4;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	double m_window_sec;			// ͳƶ֡Ĵ
+	double m_escalate_ratio;		// ڶֵ֡ʱһ
+	double m_relax_sec;				// ޶֡ʱʱһ (ʼֵ)
+
+	std::atomic<int> m_level{ 0 };
+	std::atomic<uint64_t> m_escalations{ 0 };
+
+	// ״ֻ̬Ⱦ߳з
+	Clock::time_point m_window_start;
+	Clock::time_point m_last_drop;
+	Clock::time_point m_last_change;
+	Clock::time_point m_last_relax;
+	bool m_started = false;
+	bool m_relaxed = false;			// Ƿſ (m_last_relax Ч)
+	int m_window_frames = 0;
+	int m_window_drops = 0;
+	double m_relax_hold_sec;		// ǰķſȴʱ (ʱӱ)
+
+public:
+	/**
+	 * @param window_sec ͳƶ֡Ĵ ()
+	 * @param escalate_ratio ڶֵ֡ʱһ
+	 * @param relax_sec ޶֡ʱ () ʱһ
+	 */
+	FrameSkipController(double window_sec, double escalate_ratio, double relax_sec);
+
+	/**
+	 * @brief Ⱦ̱߳һ֡Ľ
+	 * @param dropped ֡Ƿٵ
+	 */
+	void onFrame(bool dropped);
+
+	int getLevel() const;
+	uint64_t getEscalations() const;
+
+	// ȼӦ skip_frame / skip_loop_filter
+	static AVDiscard skipFrameFor(int level);
+	static AVDiscard skipLoopFilterFor(int level);
+	static const char* discardName(AVDiscard discard);
+};
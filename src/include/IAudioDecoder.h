@@ -21,6 +21,7 @@
 #pragma once
 
 #include "IClockManager.h"	// ʱӹӿڣƵ֡PTSںʱ
+#include <functional>
 
 struct AVCodecParameters;	// ṹ
 struct AVPacket;			// ݰṹ
@@ -34,6 +35,9 @@ extern "C" {
 
 class IAudioDecoder {
 public:
+	// ص false ʾֹͣȡ֡ (ζֹ)
+	using FrameCallback = std::function<bool(AVFrame* frame)>;
+
 	virtual ~IAudioDecoder() = default;
 
 	/**
@@ -47,6 +51,7 @@ public:
 
 	/**
 	* @brief ƵΪһƵ֡PCMݣ
+	* ÿεȡһ֡һ֡ʱʹ decodeAll()
 	* @param packet ѹƵݵ AVPacket
 	* @param frame ָ AVFrame ָָ룬ָ뽫PCM䣬
 	* @return ɹʱ0֡ѽ룩Ҫ򷵻 AVERROR(EAGAIN)
@@ -55,6 +60,19 @@ public:
 	*/
 	virtual int decode(AVPacket* packet, AVFrame** frame) = 0;
 
+	/**
+	* @brief һȡʱȫ֡֡ص
+	* һܽ֡ (֡Ƶ̻֡߳ѹ)ȡպŷأ֡ڽУ
+	*  (ͷ AVERROR(EAGAIN)) ʱȡ֡ڳռ䣬·ͬһᶪʧ
+	* @param packet İnullptr ʾϴȡȫʣ֡߱Ȩ
+	* @param frame õĽ֡ *frame Ϊɽһ֡߹
+	* @param onFrame ÿȡһ֡һΡص֡ (FrameQueue::push(std::move(frame)))
+	* δߵȡһ֡ǰͷţ false ʱֹͣδȡ֡ڽС
+	* @return ȡʱ0ϴϷ AVERROR_EOFصҪֹͣʱ AVERROR_EXIT
+	* (ʱδ)ʧʱظĴ롣
+	*/
+	virtual int decodeAll(AVPacket* packet, AVFrame** frame, const FrameCallback& onFrame) = 0;
+
 	/**
 	* @brief رսͷԴ
 	* ô˷󣬽ʵá
@@ -58,6 +58,17 @@ public:
      */
     virtual bool renderFrame(AVFrame* frame, const std::atomic<bool>& quit) = 0;
 
+    /**
+     * @brief Ⱦ֡Ƶ
+     * ֡زƴΪһ PCM ݣֻһεŶУ
+     * ԼƵ豸еļȾ̵߳ĻѴ
+     * @param frames ҪȾƵ֡飨˳򣩡
+     * @param count ֡
+     * @param quit ָʾ˳̵߳ı־
+     * @return ɹ trueʧܷ false
+     */
+    virtual bool renderFrames(AVFrame** frames, int count, const std::atomic<bool>& quit) = 0;
+
     /**
      * @brief ʼָƵš
      */
@@ -73,6 +84,20 @@ public:
      */
     virtual void flushBuffers() = 0;
 
+    /**
+     * @brief õӳģʽ init() ֮ǰá
+     * ʱʹøС豸壬ѲŶѹڼʮڣ
+     * ʹƵʱ (ʱ) յݡ
+     */
+    virtual void setLowLatency(bool enable) = 0;
+
+    /**
+     * @brief ò (̵߳ãһЧ)
+     * Ƶٲֱͣ׷֡ʱСٻ١
+     * @param rate ʣ1.0 Ϊԭ١
+     */
+    virtual void setPlaybackRate(double rate) = 0;
+
     /**
      * @brief رƵȾͷԴ
      */
@@ -133,4 +133,12 @@ public:
 	 * @param pts ǰ֡ʱ ()
 	 */
 	virtual void syncToPts(double pts) = 0;
+
+	/**
+	 * @brief òʡⲿʱӰʱƵʱӿ۳豸ʱҲ㡣
+	 * ֱ׷֡ʱСٻ٣ƵȾʱһ¡
+	 * @param rate ʣ1.0 Ϊԭ
+	 */
+	virtual void setPlaybackRate(double rate) = 0;
+	virtual double getPlaybackRate() const = 0;
 };
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <vector>
+
 struct AVFormatContext;
 struct AVPacket;
 struct AVCodecParameters;
@@ -31,6 +33,13 @@ extern "C" {
 
 class IDemuxer {
 public:
+	// 
+	enum class ReconnectResult {
+		FAILED,				// δ (ﵽ޻ж)
+		SAME_STREAMS,		// ѡδ仯Լʹ
+		STREAMS_CHANGED		// ѡ˱仯
+	};
+
 	// ΪṩĬϵı׼ʵ
 	virtual ~IDemuxer() = default;
 
@@ -80,6 +89,23 @@ public:
 	 */
 	virtual int findStream(AVMediaType type) const = 0;
 
+	/**
+	 * @brief гָý͵δѡел
+	 * @param type AVMEDIA_TYPE_VIDEO, AVMEDIA_TYPE_AUDIO, etc.
+	 * @return Уûи͵ʱΪ
+	 */
+	virtual std::vector<int> getStreamIndices(AVMediaType type) const = 0;
+
+	/**
+	 * @brief лָý͵ѡ
+	 * δѡеڽװ㼴 (AVDISCARD_ALL)ٶȡʹ
+	 * л readPacket ֻѡеѶľݰɵߴ
+	 * @param type AVMEDIA_TYPE_VIDEO  AVMEDIA_TYPE_AUDIO
+	 * @param streamIndex ѡе-1 ʾ͵
+	 * @return ЧͲʱ falseѡ״ֲ̬
+	 */
+	virtual bool selectStream(AVMediaType type, int streamIndex) = 0;
+
 	/**
 	 * @brief ȡָı
 	 * @param streamIndex 
@@ -92,6 +118,12 @@ public:
 	 */
 	virtual double getDuration() const = 0;
 
+	/**
+	 * @brief ȡýʼʱ (룬AVFormatContext::start_time)
+	 * ʱ 0 ʼļ ( MPEG-TS) УЧתΧΪ [ʼʱ, ʼʱ + ʱ]δ֪ʱΪ 0.0
+	 */
+	virtual double getStartTime() const = 0;
+
 	/**
 	 * @brief ȡָʱ (time_base).
 	 * @param streamIndex .
@@ -104,4 +136,11 @@ public:
 	 * @return true ֱ, false Ǳļ㲥
 	 */
 	virtual bool isLiveStream() const = 0;
+
+	/**
+	 * @brief ʵʱϿͬһ URL (ֱɹﵽ޻ж)
+	 * 󱣳ԭѡе죬ϿǰıȽ
+	 * @param max_attempts Դ0 ʾ޴
+	 */
+	virtual ReconnectResult reconnect(int max_attempts) = 0;
 };
@@ -21,6 +21,8 @@
 #pragma once
 
 #include <string>
+#include <functional>
+#include "DecoderThreadBudget.h"	// DecoderThreadType, DecoderThreadConfig
 
 struct AVCodecParameters;	// ṹ
 struct AVPacket;			// ݰṹ
@@ -34,6 +36,9 @@ extern "C" {
 
 class IVideoDecoder {
 public:
+	// ص false ʾֹͣȡ֡ (ζֹ)
+	using FrameCallback = std::function<bool(AVFrame* frame)>;
+
 	virtual ~IVideoDecoder() = default;
 
 	/**
@@ -47,14 +52,28 @@ public:
 	/**
 	* @brief ƵΪһƵ֡
 	* ߸packetframeڡ
+	* ÿεȡһ֡һ֡ʱʹ decodeAll()
 	* @param packet ѹƵݵ AVPacket
-	* @param frame ָ AVFrame ָָ룬ָ뽫Ƶ䣬
-	* ڲз/ȡһ֡
+	* @param frame ָ AVFrame ָָ룬ָ뽫Ƶ䡣
+	*  *frame ǿø֡ unrefɽһ֡߹
 	* @return ɹʱ0֡ѽ룩Ҫ򷵻 AVERROR(EAGAIN)
 	* ĩβ򷵻AVERROR_EOFʧʱظĴ롣
 	*/
 	virtual int decode(AVPacket* packet, AVFrame** frame) = 0;
 
+	/**
+	* @brief һȡʱȫ֡֡ص
+	* һܽ֡ (֡Ƶ̻֡߳ѹ)ȡպŷأ֡ڽУ
+	*  (ͷ AVERROR(EAGAIN)) ʱȡ֡ڳռ䣬·ͬһᶪʧ
+	* @param packet İnullptr ʾϴȡȫʣ֡߱Ȩ
+	* @param frame õĽ֡ *frame Ϊɽһ֡߹
+	* @param onFrame ÿȡһ֡һΡص֡ (FrameQueue::push(std::move(frame)))
+	* δߵȡһ֡ǰͷţ false ʱֹͣδȡ֡ڽС
+	* @return ȡʱ0ϴϷ AVERROR_EOFصҪֹͣʱ AVERROR_EXIT
+	* (ʱδ)ʧʱظĴ롣
+	*/
+	virtual int decodeAll(AVPacket* packet, AVFrame** frame, const FrameCallback& onFrame) = 0;
+
 	/**
 	* @brief رսͷԴ
 	* ô˷󣬽ʵá
@@ -66,6 +85,44 @@ public:
 	*/
 	virtual void flush() = 0;
 
+	/**
+	* @brief ý֡Ĳ (AVCodecContext::skip_frame)
+	* 羫ȷתʱ AVDISCARD_NONREF Ŀ֮ǰʾķǲο֡
+	* @param discard ԣAVDISCARD_DEFAULT Ϊ롣
+	*/
+	virtual void setSkipFrame(enum AVDiscard discard) = 0;
+
+	/**
+	* @brief ý· (ȥ) ˲Ĳ (AVCodecContext::skip_loop_filter)
+	* Ƶʱ֡ߣԻʻȡٶȡ
+	* @param discard ԣAVDISCARD_DEFAULT Ϊ˲
+	*/
+	virtual void setSkipLoopFilter(enum AVDiscard discard) = 0;
+
+	/**
+	* @brief õӳٽ룬 init() ֮ǰá
+	* ʱ AV_CODEC_FLAG_LOW_DELAY߳ģΪ AUTO ʱƬ̶̣߳֡߳⻺֡
+	* @param enable Ƿá
+	*/
+	virtual void setLowDelay(bool enable) = 0;
+
+	/**
+	* @brief ý߳ģ߳ init() ֮ǰá
+	* AUTO/0 ֱѡʵ߳ܽڵĽ߳Ԥ (DecoderThreadBudget) ơ
+	* @param config ߳á
+	*/
+	virtual void setThreading(const DecoderThreadConfig& config) = 0;
+
+	/**
+	* @brief ȡʵʹõ߳ (δʼʱΪ 0)
+	*/
+	virtual int getThreadCount() const = 0;
+
+	/**
+	* @brief ȡʵõ߳ģ (֧ģʱΪ NONE)
+	*/
+	virtual DecoderThreadType getThreadType() const = 0;
+
 	/**
 	* @brief ȡƵ֡Ŀ
 	* @return ȣλأ
@@ -40,6 +40,9 @@ constexpr double AV_SYNC_THRESHOLD_MIN = 0.04;
 // ֵͬƵ󳬹ֵ򴥷֡
 constexpr double AV_SYNC_THRESHOLD_MAX = 0.4;
 
+// ֡ PTS ֵֵ룩ΪʱѣΪ֡ʱʹ
+constexpr double MAX_FRAME_DURATION = 10.0;
+
 // ͬźţ calculateSyncDelay أ߶ǰ֡
 constexpr double SYNC_SIGNAL_DROP_FRAME = -1.0;
 
@@ -69,25 +72,29 @@ public:
 	 * @note ˺̰߳ȫģڡ̡߳Ƶ̣ͬ߳еá
 	 *
 	 * @param frame ָƵ AVFrame ָ롣Ӵ֡ȡPTS
+	 * @param next_frame еһ֡ (ѡ frame ͬһ)
+	 * ṩʱ֡ PTS ֮Ϊ֡ʵʳʱ䣬ݴжϱ֡Ƿ֡ڡ
 	 * @return double ͵ӳʱ䣬λΪ롣
 	 *   > 0.0: ƵʱӣҪӳٵʱ䣨룩
 	 *   = 0.0: Ӧʾ
 	 *   = SYNC_SIGNAL_DROP_FRAME: ƵͺӦ֡
 	*/
-	virtual double calculateSyncDelay(AVFrame* frame) = 0;
+	virtual double calculateSyncDelay(AVFrame* frame, const AVFrame* next_frame = nullptr) = 0;
 
 	/**
 	 * @brief ׼һʾƵִ֡зȾԤ
 	 *
-	 * ˺ִCPUܼ͵׼罫Ƶ֡ӽظʽ YUV420P
-	 * תΪȾмʽ I420Ὣ׼õ֡ݻ
+	 * ˺ִCPUܼ͵׼罫Ƶ֡ӽظʽ
+	 * תΪȾмʽ I420תᱻ
 	 * Ա displayFrame()  refresh() Կٷʡ
+	 * Ⱦֱӽܵĸʽ YUV420PNV12תֻԴ֡ݵãav_frame_ref
+	 * Ҫתʱʵֱֿд߳Ԥڴ档
 	 *
 	 * @note ˺̰߳ȫģڡ̡߳Ƶ̣ͬ߳еã
 	 * ԱȾ̡߳
 	 *
-	 * @param frame ָ AVFrame ָ롣ڲܻô֡磬䱣Ϊһ֡
-	 * ںغȻҪ av_frame_unref()
+	 * @param frame ָ AVFrame ָ롣غ󼴲ٷʴ AVFrame ṹ
+	 * ɵߣ֡УȾԳݻá
 	 * @return ֡ݳɹ׼棬򷵻 true
 	 * תʧܣ򷵻 false
 	 */
@@ -147,7 +154,13 @@ public:
 	virtual void setStreamType(bool isLive) = 0;
 
 	/**
-	 * @brief Ⱦڲ״̬һ֡PTSFirstFrameǵȣ
+	 * @brief Ⱦڲ״̬һ֡PTSFirstFrameǵȣ calculateSyncDelay() ͬһ߳е
 	 */
 	virtual void flush() = 0;
+
+	/**
+	 * @brief ȡϴε׼áʾ֮ǰͱµ֡ǵ֡߳ʾ
+	 * Щ֡ͬ֡һûбʾӦͬΪ֡ڹ߳еá
+	 */
+	virtual unsigned int takeOverwrittenFrames() = 0;
 };
@@ -0,0 +1,117 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/packet.h>	// AVPacket
+#include <libavutil/rational.h>	// AVRational
+}
+
+/**
+ * ؼ֡ڽװм¼ĳһ· (ͨΪƵ) Ĺؼ֡ PTS ֽλã
+ * ɳ־ûýļԵĻļ (sidecar)´δʱֱӰֽλ seek
+ *  MPEG-TSȱĸʽ av_seek_frame Ķֲһɨ衣
+ *
+ * ڲŹп seekɶɨƴɡÿĿ¼ǰһĿ֮
+ * Ƿɨ (contiguous)ֻĿɨʱʹ
+ * ֤©֪ؼ֮֡δ֪ؼ֡
+ * ̰߳ȫ FFmpegDemuxer һֻڽװ߳ʹá
+ */
+class KeyframeIndex {
+public:
+	struct Entry {
+		int64_t pts = 0;			// ؼ֡ PTS (ʱ)
+		int64_t pos = 0;			// ؼ֡ڰֽλ
+		uint32_t gop_packets = 0;	// Ӹùؼ֡һؼ֮֡İ (δ֪Ϊ 0)
+		bool contiguous = false;	// ǰһĿ֮Ƿɨ
+	};
+
+private:
+	int m_stream_index = -1;
+	AVRational m_time_base{ 0, 1 };
+	int64_t m_file_size = -1;		// ļС
+	int64_t m_file_mtime = 0;		// ޸ʱ
+
+	std::vector<Entry> m_entries;	//  PTS 
+	bool m_tail_complete = false;	// һĿ֮ɨ赽ļβ
+	bool m_dirty = false;			// Լ/ǷĿ
+
+	// ǰɨ״̬
+	int m_last_key = -1;			// ɨһؼ֡Ŀ± (-1=շת)
+	uint32_t m_packets_since_key = 0;
+
+public:
+	KeyframeIndex() = default;
+
+	/**
+	 * @brief 󶨵ָ
+	 * @param file_size / file_mtime ýļĴС޸ʱ䣬ΪļУ
+	 */
+	void reset(int stream_index, AVRational time_base, int64_t file_size, int64_t file_mtime);
+
+	/**
+	 * @brief ¼һѶİ (İᱻ)
+	 */
+	void addPacket(const AVPacket* packet);
+
+	/**
+	 * @brief ֪ͨת˺Ĺؼ֮֡ǰĿΪ
+	 */
+	void onDiscontinuity();
+
+	/**
+	 * @brief ֪ͨɨѵļβ
+	 */
+	void onEndOfFile();
+
+	/**
+	 * @brief ҲĿʱĹؼ֡
+	 * @param target_pts Ŀ PTS (ʱ)
+	 * @param entry ҵĿ
+	 * @return Ŀɨʱ trueӦ˻ seek
+	 */
+	bool lookup(int64_t target_pts, Entry& entry) const;
+
+	/**
+	 * @brief ӻļļС޸ʱƥʱ false Ϊ
+	 */
+	bool load(const std::string& path);
+
+	/**
+	 * @brief д뻺ļ
+	 */
+	bool save(const std::string& path);
+
+	int streamIndex() const { return m_stream_index; }
+	size_t size() const { return m_entries.size(); }
+	bool isDirty() const { return m_dirty; }
+	const std::vector<Entry>& entries() const { return m_entries; }
+
+	/**
+	 * @brief ȡýļĴС޸ʱ
+	 * @return ļڻ򲻿ɷʱ false
+	 */
+	static bool statFile(const std::string& path, int64_t& file_size, int64_t& file_mtime);
+};
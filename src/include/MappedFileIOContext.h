@@ -0,0 +1,98 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+extern "C" {
+#include <libavformat/avio.h>
+#include <libavutil/error.h>	// AVERROR
+#include <libavutil/mem.h>		// av_malloc
+}
+
+/**
+ * ڴӳıļ AVIOContext
+ * ļֻʽӳ䵽̵ַռ䣬صֱӴӳݣseek ֻƶλã
+ * ҳ棬ʡȥÿζȡϵͳúں˵û̬һθơ
+ *  direct ģʽװȡʱƹ AVIOContext ڲ壬ӳֱӸƵ塣
+ * λǰһͨ madvise(MADV_WILLNEED) (Windows Ϊ PrefetchVirtualMemory) ʾںԤ
+ * ע⣺ڼļضϣӳᴥ SIGBUSֻڱصľ̬ļ
+ */
+class MappedFileIOContext {
+private:
+	//  avio_alloc_context ڲС (direct ģʽֻͷСȡ)
+	static constexpr int IO_BUFFER_SIZE = 32 * 1024;
+	// λǰʾںԤķΧ
+	static constexpr size_t ADVISE_WINDOW = 8 * 1024 * 1024;
+
+	const uint8_t* m_data = nullptr;	// ӳ
+	int64_t m_size = 0;					// ļС
+	int64_t m_pos = 0;					// ǰλ
+	int64_t m_advised_end = 0;			// ʾԤյ
+	AVIOContext* m_avio = nullptr;
+
+#ifdef _WIN32
+	void* m_file_handle = nullptr;		// HANDLE
+	void* m_mapping_handle = nullptr;	// HANDLE
+#endif
+
+public:
+	MappedFileIOContext() = default;
+	~MappedFileIOContext();
+
+	/**
+	 * @brief ӳ䱾ļ AVIOContext
+	 * @param url · "file:" ͷ URL
+	 * @return ɹ 0ʧܷ FFmpeg  (ļӳʧʱӦ˻Ĭ IO)
+	 */
+	int open(const char* url);
+
+	/**
+	 * @brief ͷ AVIOContext ӳ䡣 avformat_close_input ֮
+	 */
+	void close();
+
+	/**
+	 * @brief ȡ AVFormatContext::pb 
+	 */
+	AVIOContext* getAVIOContext() const { return m_avio; }
+
+	/**
+	 * @brief ж URL ǷΪӳıļ (file Э)
+	 */
+	static bool isLocalFile(const char* url);
+
+	MappedFileIOContext(const MappedFileIOContext&) = delete;
+	MappedFileIOContext& operator=(const MappedFileIOContext&) = delete;
+
+private:
+	// AVIOContext ص (ڽװ߳е)
+	static int readCallback(void* opaque, uint8_t* buf, int buf_size);
+	static int64_t seekCallback(void* opaque, int64_t offset, int whence);
+
+	//  [m_pos, m_pos + ADVISE_WINDOW) ʾںԤ
+	void adviseAhead();
+
+	bool mapFile(const std::string& path);
+	void unmapFile();
+};
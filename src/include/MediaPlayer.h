@@ -26,6 +26,7 @@
 #include <memory>
 #include <mutex>
 #include <condition_variable>
+#include <cmath>
 
 // ǰ FFmpeg 
 struct AVCodecParameters;
@@ -35,6 +36,9 @@ struct SwsContext;
 
 // ӿͷļ
 #include "PacketQueue.h"    // ݰ
+#include "StreamPacketBuffer.h" // ·֯ݰ
+#include "TimeshiftBuffer.h"  // ʵʱʱƻ
+#include "StreamRecorder.h"   // ʵʱ¼
 #include "FrameQueue.h"     // ֡
 #include "IDemuxer.h"       // ⸴
 #include "IVideoDecoder.h"  // Ƶ
@@ -42,6 +46,7 @@ struct SwsContext;
 #include "IVideoRenderer.h" // ƵȾ
 #include "IAudioRenderer.h" // ƵȾ
 #include "IClockManager.h"  // ʱӹ
+#include "FrameSkipController.h" // ǰ֡
 
 #include "PlayerDebugStats.h" // Ϣ
 
@@ -71,6 +76,12 @@ public:
         STOPPED     // ֹͣ/
     };
 
+    // תģʽ
+    enum class SeekMode {
+        KEYFRAME,   // ٣Ŀ֮ǰĹؼ֡
+        ACCURATE    // ȷӹؼ֡벢Ŀ֮ǰ֡
+    };
+
 private:
     // ڲ״̬־
     std::atomic<bool> m_quit{ false };   // ˳־
@@ -81,23 +92,59 @@ private:
 
     // ڲ״̬
     int videoStreamIndex = -1;  // ⸴ҵƵ
-    int audioStreamIndex = -1;  // Ƶ
+    std::atomic<int> audioStreamIndex{ -1 };  // ǰƵ (лʱɽװ̸߳)
 
     // 
     std::atomic<int> m_seek_serial{ 0 }; // ȫкţڲ""
     std::shared_ptr<PlayerDebugStats> m_debugStats; // Ϣ
+    QueueStatsSnapshot m_prevQueueStats[QSTATS_COUNT]; // һηĶͳƣڼ (̷߳)
+    Uint32 m_prevQueueStatsTicks = 0;                  // һηʱ (SDL_GetTicks)
     std::atomic<bool> m_wait_for_keyframe{ true }; // ־-Ƿǹؼ֡
+    bool m_low_latency = false;                    // ǰǷΪӳģʽµʵʱ (ʼֻ)
+    std::atomic<double> m_live_edge_sec{ std::nan("") };  // ʵʱյݰʱ ()
+    double m_playback_rate = 1.0;                          // ǰ (̷߳)
+    std::atomic<bool> m_timeshifted{ false };              // ʵʱĲλ뿪ֱԵ (ͣؿ)صֱǰ׷֡
+    std::atomic<int64_t> m_live_realtime_origin_us{ AV_NOPTS_VALUE }; // ʵʱ pts=0 ӦĲɼʱ (Unix ΢)δ֪ʱΪ AV_NOPTS_VALUE
+
+    // --- ת ---
+    // ߳д룬ɽװ߳ȡִ (⸴ֻڽװ߳з)
+    std::mutex m_seek_mutex;
+    double m_seek_req_target = 0.0;                 // Ŀʱ () m_seek_mutex 
+    SeekMode m_seek_req_mode = SeekMode::KEYFRAME;  //  m_seek_mutex 
+    Uint64 m_seek_req_counter = 0;                  // 󷢳ʱ (SDL_GetPerformanceCounter) m_seek_mutex 
+    std::atomic<bool> m_seek_pending{ false };      // δִеת
+    std::atomic<bool> m_seek_in_flight{ false };    // תѷе֡δʾ
+    std::atomic<double> m_last_seek_target{ 0.0 };  // һתĿ꣬ʱΪתĻ׼
+    // ȷתĿ֮ǰ֡ڽ
+    std::atomic<int> m_accurate_seek_serial{ -1 };
+    std::atomic<double> m_accurate_seek_target{ 0.0 };
+    // ֡ӳٲеĵһ֡ʾʱ¼ʾĺʱ
+    std::atomic<int> m_seek_latency_serial{ -1 };
+    std::atomic<Uint64> m_seek_latency_start{ 0 };
+
+    // --- л ---
+    // תͬ߳д룬ɽװִ߳
+    std::atomic<int> m_audio_track_request{ -1 };   // лƵ-1 ʾûй
+
+    // --- ¼ ---
+    // תͬ߳д룬ɽװִ߳
+    std::atomic<int> m_record_request{ -1 };        // 1=ʼ¼ƣ0=ֹͣ¼ƣ-1 ʾûй
 
     // ڲ
     std::unique_ptr<PacketQueue> m_videoPacketQueue;
     std::unique_ptr<PacketQueue> m_audioPacketQueue;
+    std::unique_ptr<StreamPacketBuffer> m_packetBuffer; // ļͳһ· PacketQueue (ֱʱΪ)
+    std::unique_ptr<TimeshiftBuffer> m_timeshift;       // ʵʱʱƻ (װ̷߳ʣļδʱΪ)
+    std::unique_ptr<StreamRecorder> m_recorder;         // ʵʱ¼ (ʼ/ֹͣ/ύֻڽװ߳еãļʱΪ)
     std::unique_ptr<FrameQueue> m_videoFrameQueue;
     std::unique_ptr<FrameQueue> m_audioFrameQueue;
 
     AVPacket* m_decodingVideoPacket = nullptr;
-    AVPacket* m_decodingAudioPacket = nullptr;
-    AVFrame* m_renderingVideoFrame = nullptr;
-    AVFrame* m_renderingAudioFrame = nullptr;
+    // Ƶ/֡СƵʸߣȾ̰߳ȡԼٻѴ
+    static constexpr size_t AUDIO_DECODE_BATCH = 16;    // Ƶ߳ÿȡİ
+    static constexpr size_t AUDIO_RENDER_BATCH = 8;     // ƵȾ߳ÿȡ֡
+    AVPacket* m_decodingAudioPackets[AUDIO_DECODE_BATCH] = {};
+    AVFrame* m_renderingAudioFrames[AUDIO_RENDER_BATCH] = {};
 
     // ϵMediaPlayer HAS-A IWorker
     std::unique_ptr<IDemuxer> m_demuxer;                // ⸴
@@ -106,6 +153,7 @@ private:
     std::unique_ptr<IVideoRenderer> m_videoRenderer;    // ƵȾ
     std::unique_ptr<IAudioRenderer> m_audioRenderer;    // ƵȾ
     std::unique_ptr<IClockManager> m_clockManager;      // ʱӹ
+    std::unique_ptr<FrameSkipController> m_frameSkip;   // ǰ֡ (Ⱦ̱߳棬Ƶ߳ӦãδʱΪ)
 
     // ڲ߳̾
     SDL_Thread* m_demuxThread = nullptr;        // ⸴
@@ -121,6 +169,88 @@ private:
     //  BUFFERING ״̬£峬ֵʱָ PLAYING ״̬
     static constexpr double PLAYOUT_THRESHOLD_SEC = 2.0;
 
+    // --- ʵʱӳģʽ ---
+    // ú RTSP/RTMP ʵʱԵӳٲ򿪣/ָֻһСĶ壬
+    // ʹ low_delayƵ豸ֻѹʮ (Ϊ false ָԭеԼ 2 뻺)
+    static constexpr bool LIVE_LOW_LATENCY = true;
+    static constexpr double LOW_LATENCY_JITTER_SEC = 0.15;  // Ŀ꣺峬ʱʼ
+    static constexpr int LOW_LATENCY_JITTER_PKTS = 4;       // ʱɿʱж
+    static constexpr double LOW_LATENCY_QUEUE_SEC = 0.5;    // ʱޣʱ GOP 
+
+    // --- ʵʱ׷֡ (ٲ) ---
+    // ӳ (յ뵱ǰλ֮) ƫĿʱСٻ٣ƽذӳĿ꣬
+    // ֡Ƶٲʱ԰ GOP 
+    static constexpr bool LIVE_CATCH_UP = true;
+    static constexpr double LIVE_TARGET_LATENCY_SEC = 1.0;      // ֱͨģʽĿӳ
+    static constexpr double LOW_LATENCY_TARGET_SEC = 0.2;       // ӳģʽĿӳ
+    static constexpr double CATCH_UP_DEADBAND_SEC = 0.05;       // ƫڴ˷Χڱԭ
+    static constexpr double CATCH_UP_GAIN = 0.1;                // ÿƫӦʵ
+    static constexpr double CATCH_UP_MAX_RATE = 1.10;
+    static constexpr double CATCH_UP_MIN_RATE = 0.95;
+    static constexpr double CATCH_UP_RATE_STEP = 0.01;          // ÿʵ仯
+
+    // --- ʵʱʱ (Timeshift) ---
+    // ͣڼյİ¼ڴеʱƻ壬ָʱͣŲţҹؼ֡»壻
+    // ڿתؿEnd صֱ (Ϊ false ָͣʱָʱͬĲ)
+    static constexpr bool LIVE_TIMESHIFT = true;
+    static constexpr double TIMESHIFT_MAX_SEC = 300.0;  // ʱƴʱ
+    static constexpr size_t TIMESHIFT_MAX_MB = 256;     // ʱƻڴ (MB)
+
+    // --- ʵʱ¼ ---
+    // R ʼ/ֹͣʵʱתװΪֶļ벥Źİظ±룻
+    // д̸ʱ¼ư GOP ŲӰ
+    static constexpr bool RECORD_ON_START = false;                  // ʵʱʼ¼
+    static constexpr const char* RECORD_FORMAT = "matroska";        // "matroska"  "mp4" (Ƭ MP4)
+    static constexpr const char* RECORD_PATH_PREFIX = "record_";    // ļǰ׺ (ɰĿ¼)
+    static constexpr double RECORD_SEGMENT_SEC = 600.0;             // ֶʱһؼ֡лļ
+    static constexpr size_t RECORD_QUEUE_MB = 32;                   // ¼деڴ (MB)
+
+    // --- ʵʱ ---
+    // ʱָ˱ͬһ URLѡıʱѴ򿪵Ľ
+    // ֻʼµĲвȴؼ֡ (Ϊ false ָ)
+    static constexpr bool LIVE_RECONNECT = true;
+    static constexpr int LIVE_RECONNECT_MAX_ATTEMPTS = 0;   // ÿζ0 ʾ
+    static constexpr int LIVE_OPEN_TIMEOUT_MS = 5000;       //  (ÿ) ʱ
+    static constexpr int LIVE_READ_TIMEOUT_MS = 3000;       // ղκݳʱΪ
+
+    // --- װԤ ---
+    // ļ HTTP ɺ̨߳ԤôСĻλ (0=رգʹ FFmpeg Ĭ IO)
+    static constexpr size_t DEMUX_READ_AHEAD_MB = 8;
+    // ļͨڴӳȡ (ӳʧʱ˻Ԥ)
+    static constexpr bool DEMUX_USE_MMAP = true;
+    // Ϊ MPEG-TS ȱıļάؼ֡ (.kfidx) seek
+    static constexpr bool DEMUX_KEYFRAME_INDEX = true;
+
+    // --- Ƶ߳ ---
+    // ߳ģ߳AUTO/0 ֱѡ (ӳֱΪƬ߳)
+    // ͬһڵƵ߳Ԥ㣬ʱֵֻʣ߳
+    static constexpr DecoderThreadType VIDEO_DECODE_THREAD_TYPE = DecoderThreadType::AUTO;
+    static constexpr int VIDEO_DECODE_THREADS = 0;
+    static constexpr int DECODE_THREAD_BUDGET = 0;      // ڽ߳ޣ0 ʾ CPU 
+
+    // --- ǰ֡ ---
+    // Ⱦ߳ٵ֡ʱý·˲ / ǲο֡ / B ֡ / ǹؼ֡
+    // ׷Ϻ𼶻ָ (Ϊ false ֻȾʱٵ֡)
+    static constexpr bool FRAME_SKIP_ADAPTIVE = true;
+    static constexpr double FRAME_SKIP_WINDOW_SEC = 1.0;    // ͳƶ֡Ĵ
+    static constexpr double FRAME_SKIP_DROP_RATIO = 0.1;    // ڶֵ֡ʱһ
+    static constexpr double FRAME_SKIP_RELAX_SEC = 3.0;     // ޶֡ʱʱһ (ʱԶӱ)
+
+    // --- ֡ڴԤ ---
+    // Ƶ֡ȰԤ / ֽ֡㣬 [MIN, MAX] ֮
+    static constexpr size_t VIDEO_FRAME_BUDGET_MB = 128; // Ƶ֡פڴ (MB)
+    static constexpr size_t MIN_VIDEO_FRAMES = 3;        // Сȣ֤ս붶
+    static constexpr size_t MAX_VIDEO_FRAMES = 24;       // βλ (ͷֱʱ)
+    static constexpr size_t MAX_AUDIO_FRAMES = 10;
+
+    // --- ת () ---
+    static constexpr double SEEK_STEP_SHORT_SEC = 5.0;  // /ҷ
+    static constexpr double SEEK_STEP_LONG_SEC = 60.0;  // /·
+
+    // --- ͳ ---
+    static constexpr Uint32 QUEUE_STATS_PUBLISH_INTERVAL_MS = 1000; // Ϣļ
+    static constexpr Uint32 QUEUE_STATS_DUMP_INTERVAL_MS = 5000;    // ɶ־ļ (0=ر)
+
 public:
     MediaPlayer(const std::string& filepath);
     virtual ~MediaPlayer();
@@ -130,6 +260,44 @@ public:
 
     int runMainLoop();      // ѭ
 
+    /**
+     * @brief תָʱ (̵߳ãʵʱֻʱƴת)
+     * תɽװ߳첽ִУͨкʹ;İ֡ʧЧҪſչ̡߳
+     * @param target_sec Ŀʱ (룬ʱ)Χʱضϵ [ʼʱ, ʼʱ + ʱ]ʵʱضϵʱƴ
+     * @param mode ؼ֡ת֡ȷת
+     */
+    void seek(double target_sec, SeekMode mode = SeekMode::KEYFRAME);
+    /**
+     * @brief ԵǰλתһתδʾʱĿΪ׼ʹۼ
+     */
+    void seekRelative(double delta_sec, SeekMode mode = SeekMode::KEYFRAME);
+    /**
+     * @brief һת»ʾĺʱ ()޼¼ʱ -1
+     */
+    double getLastSeekLatencyMs() const;
+    /**
+     * @brief ʵʱͣؿλûصֱʱƻµĹؼ֡ (δʱʱЧ)
+     */
+    void jumpToLive();
+
+    /**
+     * @brief л (̵߳)
+     * ⸴漴졢ʼ죻ѻľճ
+     * ƵĲ³ʼƵӰ
+     * @param stream_index  ( IDemuxer::getStreamIndices)
+     */
+    void switchAudioTrack(int stream_index);
+    /**
+     * @brief лһ죬һصһ
+     */
+    void cycleAudioTrack();
+
+    /**
+     * @brief ʼ/ֹͣ¼ʵʱ (̵߳ãļЧ)
+     * ¼ưʼʱѡеƵ죬ֹͣд߳дŶӵٹرļ
+     */
+    void toggleRecording();
+
 private:
     // ߳ں
     // Ϊ˼SDL API̬ںʵ߼
@@ -145,11 +313,38 @@ private:
     int audio_render_func();
     static int control_thread_entry(void* opaque);
     int control_thread_func();
+    // ɼжеͳƿգʺ󷢲Ϣdump Ϊ true ʱͬʱһ JSON ־
+    void publish_queue_stats(bool dump);
 
 private:
     // ¼
     int handle_event(const SDL_Event& event);
     void resync_after_pause();
+    // ڽװִ߳йת
+    void handle_seek_request();
+    // תȷʼµĲУʹ;İ֡ʧЧʱΪδ֪
+    void begin_seek_serial(double target, SeekMode mode, Uint64 requested_at);
+    // ѰӦĲŶ (ʱĹؼֱ֡ GOP Ƶü)ǰͷ packet
+    void dispatch_packet(AVPacket* packet, bool isLive, const AVRational& video_tb, const AVRational& audio_tb);
+    // ʵʱյһ¼հʱֱԵַ¼ʱƻ壻ذǷ¼ʱƻ
+    bool ingest_live_packet(AVPacket* packet, const AVRational& video_tb, const AVRational& audio_tb);
+    // ʱƻĶα괦ȡ벥ŶУֱԵʱȫͳ뿪Ե󰴶Ҫͳ
+    void feed_from_timeshift(AVPacket* packet, bool isLive, const AVRational& video_tb, const AVRational& audio_tb);
+    // ǲλǷ뿪ֱԵлŶеز
+    void set_timeshifted(bool timeshifted);
+    // ڽװִ߳йл
+    void handle_audio_track_request();
+    // ڽװִ߳йĿʼ/ֹͣ¼
+    void handle_record_request();
+    // ʵʱڽװ߳ (ɹ)ԱʱʼµĲС
+    // ʱ true false ʱԭеĳ̽
+    bool reconnect_live_stream(AVRational& video_tb, AVRational& audio_tb);
+    // ̳߳ϴϺ󱣳ִȴתʼµĲ (˳)ڼ䲻ռ CPU
+    void wait_for_new_serial(PacketQueue* queue, int eof_serial);
+    // ʵʱ֡ʾʱհʾɼʾӳͳ
+    void record_live_latency(const AVFrame* frame);
+    // ߳аʵʱӳٵʣactive Ϊ false ʱ𲽻ص 1.0
+    void update_live_playback_rate(bool active);
     // ͳʼ
     void init_components(const std::string& filepath);
     void init_ffmpeg_resources(const std::string& filepath);
@@ -23,6 +23,8 @@
 #include "SDL2/SDL.h"
 #include "SDL2/SDL_ttf.h"
 #include "PlayerDebugStats.h"
+#include "DecoderThreadBudget.h"
+#include "FrameSkipController.h"
 #include <string>
 #include <sstream>
 #include <iomanip>
@@ -36,6 +38,41 @@ private:
     const int LINE_HEIGHT = 20;
 
 private:
+    // ͳҳÿ (ˮλ / ȴ)
+    void buildQueueStatsLines(const PlayerDebugStats& stats, std::vector<std::string>& lines) const {
+        QueueStatsSnapshot snapshots[QSTATS_COUNT];
+        {
+            std::lock_guard<std::mutex> lock(stats.queue_stats_mutex);
+            for (int i = 0; i < QSTATS_COUNT; ++i) {
+                snapshots[i] = stats.queue_stats[i];
+            }
+        }
+
+        lines.push_back("Queues (Tab: next page)");
+        std::ostringstream oss;
+        for (int i = 0; i < QSTATS_COUNT; ++i) {
+            const QueueStatsSnapshot& s = snapshots[i];
+            oss << queueStatsLabel(i) << ": " << s.size << "/" << s.capacity
+                << " (lo " << s.low_watermark << ", hi " << s.high_watermark << ")"
+                << std::fixed << std::setprecision(0)
+                << " in " << s.push_rate << "/s out " << s.pop_rate << "/s";
+            if (s.drops > 0) {
+                oss << " drop " << s.drops;
+            }
+            lines.push_back(oss.str());
+            oss.str(""); oss.clear();
+
+            // ƽȴʱ ()˵˵
+            double p_avg = s.producer_waits ? s.producer_wait_us / 1000.0 / s.producer_waits : 0.0;
+            double c_avg = s.consumer_waits ? s.consumer_wait_us / 1000.0 / s.consumer_waits : 0.0;
+            oss << "    wait P " << s.producer_waits << "x " << std::setprecision(1) << p_avg << "ms"
+                << " | C " << s.consumer_waits << "x " << c_avg << "ms"
+                << " | lock max " << s.lock_hold_max_us << "us";
+            lines.push_back(oss.str());
+            oss.str(""); oss.clear();
+        }
+    }
+
     // ʱתΪַ
     std::string getClockSourceName(int type) const {
         switch (type) {
@@ -82,67 +119,216 @@ public:
 
         std::vector<std::string> lines;
         std::ostringstream oss;
+        int boxW = 350; // ʵ
 
-        // --- Player State ---
-        oss << "State: ";
-        int stateVal = stats.current_state.load();
-        switch (stateVal) {
-        case 0: oss << "IDLE"; break;
-        case 1: oss << "BUFFERING..."; break;
-        case 2: oss << "PLAYING"; break;
-        case 3: oss << "PAUSED"; break;
-        case 4: oss << "STOPPED"; break;
-        default: oss << "UNKNOWN (" << stateVal << ")"; break;
-        }
-        lines.push_back(oss.str());
-        oss.str(""); oss.clear();
-
-        // --- V-Q Info ---
-        // duration תΪ룬2λС
-        double vq_sec = stats.vq_duration_ms.load() / 1000.0;
-        oss << "V-Q: " << stats.vq_size.load() << " pkts / "
-            << std::fixed << std::setprecision(2) << vq_sec << " sec";
-        lines.push_back(oss.str());
-        oss.str(""); oss.clear();
-
-        // --- A-V Sync ---
-        // Ԥȼԭӱ
-        int clockSrcType = stats.clock_source_type.load();
-        double masterTime = stats.master_clock_val.load();
-        double videoPts = stats.video_current_pts.load();
-        double avDiff = stats.av_diff_ms.load();
-
-        // Clock Status (ʱԴ뵱ǰʱ) 
-        oss << "Clock: " << getClockSourceName(clockSrcType);
-        // ֻʱͬ(-1)ʱȡʱȷʵЧʱʾʱʱ
-        if (clockSrcType != -1 && !std::isnan(masterTime)) {
-            oss << " | T: " << std::fixed << std::setprecision(2) << masterTime << "s";
-        }
-        lines.push_back(oss.str());
-        oss.str(""); oss.clear();
-
-        // A-V Sync (ֵͬƵPTS)
-        //  Syncing ״̬Diff ݿܾ޴Ϊ 0زʾռλ
-        if (clockSrcType == -1) {
-            oss << "Sync: --";
+        if (stats.osd_page.load() == 1) {
+            buildQueueStatsLines(stats, lines);
+            boxW = 520;
         }
         else {
-            oss << "Sync: " << std::fixed << std::setprecision(1) << avDiff << " ms"
-                << " (V-PTS: " << std::setprecision(2) << videoPts << ")";
-        }
-        lines.push_back(oss.str());
-        oss.str(""); oss.clear();
+            // --- Player State ---
+            oss << "State: ";
+            int stateVal = stats.current_state.load();
+            switch (stateVal) {
+            case 0: oss << "IDLE"; break;
+            case 1: oss << "BUFFERING..."; break;
+            case 2: oss << "PLAYING"; break;
+            case 3: oss << "PAUSED"; break;
+            case 4: oss << "STOPPED"; break;
+            default: oss << "UNKNOWN (" << stateVal << ")"; break;
+            }
+            lines.push_back(oss.str());
+            oss.str(""); oss.clear();
+
+            // --- V-Q Info ---
+            // duration תΪ룬2λС
+            double vq_sec = stats.vq_duration_ms.load() / 1000.0;
+            oss << "V-Q: " << stats.vq_size.load() << " pkts / "
+                << std::fixed << std::setprecision(2) << vq_sec << " sec";
+            lines.push_back(oss.str());
+            oss.str(""); oss.clear();
 
-        // --- FPS ---
-        oss << "FPS: Decode " << stats.decode_fps.getFPS()
-            << " / Render " << stats.render_fps.getFPS();
-        lines.push_back(oss.str());
+            // --- Frame Queue Info ---
+            // פ֡ڴ MB ʾ
+            double vf_mb = stats.vf_bytes.load() / (1024.0 * 1024.0);
+            double af_mb = stats.af_bytes.load() / (1024.0 * 1024.0);
+            oss << "V-F: " << stats.vf_size.load() << "/" << stats.vf_capacity.load() << " frames / "
+                << std::fixed << std::setprecision(1) << vf_mb << " MB | A-F: "
+                << std::setprecision(2) << af_mb << " MB";
+            lines.push_back(oss.str());
+            oss.str(""); oss.clear();
+
+            // --- Read-ahead IO Info ---
+            // Ԥʱʾ
+            unsigned long long ioHits = stats.io_hits.load();
+            unsigned long long ioMisses = stats.io_misses.load();
+            if (ioHits + ioMisses > 0) {
+                double hitRate = 100.0 * ioHits / (ioHits + ioMisses);
+                oss << "IO: hit " << std::fixed << std::setprecision(1) << hitRate << "% / "
+                    << ioMisses << " misses / wait " << stats.io_wait_ms.load() << " ms";
+                lines.push_back(oss.str());
+                oss.str(""); oss.clear();
+            }
+
+            // --- Live Drop Info ---
+            // ڷʱʾ
+            unsigned long long vDrop = stats.vq_dropped_pkts.load();
+            unsigned long long aDrop = stats.aq_dropped_pkts.load();
+            if (vDrop > 0 || aDrop > 0) {
+                oss << "Drop: V " << vDrop << " pkts (" << stats.vq_gop_drops.load() << " GOPs)"
+                    << " / A " << aDrop << " pkts";
+                lines.push_back(oss.str());
+                oss.str(""); oss.clear();
+            }
+
+            // --- Seek Latency ---
+            // ڷתʱʾ
+            unsigned long long seekCount = stats.seek_count.load();
+            if (seekCount > 0) {
+                oss << "Seek: last " << std::fixed << std::setprecision(0) << stats.seek_last_ms.load()
+                    << " ms / avg " << stats.seek_avg_ms.load() << " ms (" << seekCount << ")";
+                lines.push_back(oss.str());
+                oss.str(""); oss.clear();
+            }
+
+            // --- Live Latency ---
+            // ʵʱʾ
+            double recvLatency = stats.live_recv_latency_ms.load();
+            double glassLatency = stats.live_glass_latency_ms.load();
+            if (recvLatency >= 0.0 || glassLatency >= 0.0) {
+                oss << "Latency: " << std::fixed << std::setprecision(0);
+                if (glassLatency >= 0.0) {
+                    oss << glassLatency << " ms glass-to-glass / ";
+                }
+                if (recvLatency >= 0.0) {
+                    oss << recvLatency << " ms recv-to-display";
+                }
+                lines.push_back(oss.str());
+                oss.str(""); oss.clear();
+            }
+
+            // --- Live Catch-up ---
+            // ʱƻؿʱ׷֡ Timeshift ʾֱʱ
+            double liveLag = stats.live_lag_ms.load();
+            bool timeshifted = stats.timeshifted.load();
+            if (liveLag >= 0.0 && !timeshifted) {
+                oss << "Catch-up: " << std::fixed << std::setprecision(2) << stats.playback_rate.load() << "x"
+                    << std::setprecision(0) << " (lag " << liveLag << " ms / target " << stats.live_target_ms.load() << " ms)";
+                lines.push_back(oss.str());
+                oss.str(""); oss.clear();
+            }
+
+            // --- Live Timeshift ---
+            double timeshiftWindow = stats.timeshift_window_sec.load();
+            if (timeshiftWindow >= 0.0) {
+                oss << "Timeshift: " << std::fixed << std::setprecision(1);
+                if (timeshifted && liveLag >= 0.0) {
+                    oss << "-" << liveLag / 1000.0 << " s";
+                }
+                else {
+                    oss << "live";
+                }
+                oss << std::setprecision(0) << " (window " << timeshiftWindow << " s / "
+                    << stats.timeshift_mb.load() << " MB)";
+                lines.push_back(oss.str());
+                oss.str(""); oss.clear();
+            }
+
+            // --- Live Reconnect ---
+            // ʾ
+            unsigned long long outages = stats.live_outages.load();
+            if (outages > 0) {
+                oss << "Reconnect: " << (stats.live_reconnecting.load() ? "in progress, " : "")
+                    << outages << " outage(s), " << stats.live_reconnect_attempts.load() << " attempt(s)";
+                double lastReconnect = stats.live_reconnect_ms.load();
+                oss << std::fixed << std::setprecision(0);
+                if (lastReconnect >= 0.0) {
+                    oss << ", last " << lastReconnect << " ms";
+                }
+                oss << ", total " << stats.live_outage_total_ms.load() << " ms";
+                lines.push_back(oss.str());
+                oss.str(""); oss.clear();
+            }
+
+            // --- Recording ---
+            if (stats.recording.load()) {
+                oss << "REC: " << std::fixed << std::setprecision(1) << stats.record_mb.load() << " MB in "
+                    << stats.record_segments.load() << " segment(s), queue " << stats.record_queue_kb.load() << " KB";
+                unsigned long long recordGaps = stats.record_gaps.load();
+                if (recordGaps > 0) {
+                    oss << ", dropped " << stats.record_dropped_pkts.load() << " pkts (" << recordGaps << " gaps)";
+                }
+                lines.push_back(oss.str());
+                oss.str(""); oss.clear();
+            }
+
+            // --- Audio Track ---
+            // жʱʾ
+            int trackCount = stats.audio_track_count.load();
+            if (trackCount > 1) {
+                oss << "Audio track: " << stats.audio_track.load() << "/" << trackCount;
+                lines.push_back(oss.str());
+                oss.str(""); oss.clear();
+            }
+
+            // --- A-V Sync ---
+            // Ԥȼԭӱ
+            int clockSrcType = stats.clock_source_type.load();
+            double masterTime = stats.master_clock_val.load();
+            double videoPts = stats.video_current_pts.load();
+            double avDiff = stats.av_diff_ms.load();
+
+            // Clock Status (ʱԴ뵱ǰʱ) 
+            oss << "Clock: " << getClockSourceName(clockSrcType);
+            // ֻʱͬ(-1)ʱȡʱȷʵЧʱʾʱʱ
+            if (clockSrcType != -1 && !std::isnan(masterTime)) {
+                oss << " | T: " << std::fixed << std::setprecision(2) << masterTime << "s";
+            }
+            lines.push_back(oss.str());
+            oss.str(""); oss.clear();
+
+            // A-V Sync (ֵͬƵPTS)
+            //  Syncing ״̬Diff ݿܾ޴Ϊ 0زʾռλ
+            if (clockSrcType == -1) {
+                oss << "Sync: --";
+            }
+            else {
+                oss << "Sync: " << std::fixed << std::setprecision(1) << avDiff << " ms"
+                    << " (V-PTS: " << std::setprecision(2) << videoPts << ")";
+            }
+            lines.push_back(oss.str());
+            oss.str(""); oss.clear();
+
+            // --- FPS ---
+            oss << "FPS: Decode " << stats.decode_fps.getFPS();
+            int decodeThreads = stats.decode_threads.load();
+            if (decodeThreads > 0) {
+                oss << " (" << DecoderThreadBudget::typeName(static_cast<DecoderThreadType>(stats.decode_thread_type.load()))
+                    << " x" << decodeThreads << ")";
+            }
+            oss << " / Render " << stats.render_fps.getFPS();
+            unsigned long long renderDropped = stats.render_dropped_frames.load();
+            if (renderDropped > 0) {
+                oss << " (dropped " << renderDropped << ")";
+            }
+            lines.push_back(oss.str());
+
+            // --- ǰ֡ (Чʱʾ) ---
+            int skipLevel = stats.frame_skip_level.load();
+            if (skipLevel > 0) {
+                oss.str(""); oss.clear();
+                oss << "Decode skip: L" << skipLevel
+                    << " (frames " << FrameSkipController::discardName(FrameSkipController::skipFrameFor(skipLevel))
+                    << ", loop filter " << FrameSkipController::discardName(FrameSkipController::skipLoopFilterFor(skipLevel)) << ")"
+                    << " x" << stats.frame_skip_escalations.load();
+                lines.push_back(oss.str());
+            }
+        }
 
         // --- ʼ ---
 
         // 
         int padding = 10;
-        int boxW = 350; // ʵ
         int boxH = static_cast<int>(lines.size() * LINE_HEIGHT) + padding * 2;
         int startX = 10;
         int startY = 10;
@@ -20,67 +20,185 @@
 
 #pragma once
 
-#include <queue>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>	// std::chrono::milliseconds
 #include <atomic>
+#include <cstdint>	// SIZE_MAX
+
+#include "QueueStats.h"
 
 extern "C" {
 #include <libavcodec/avcodec.h> // AVPacket & AVFrame
 }
 
+/**
+ * /ߵĶλС
+ * λе AVPacket ڹʱһԤ䣬push/pop Ŀ·ڴ棬
+ * ڶΪգߣߣʱŻ˵ mutex +  ȴ
+ * ÿλ (seq)жλ
+ * ʹֱģʽҲܰȫضɵݰ
+ */
 class PacketQueue {
 private:
-	// ڲݴ洢ṹ
-	struct PacketData {
-		AVPacket* pkt = nullptr;
+	// ڲλṹ
+	struct PacketSlot {
+		std::atomic<size_t> seq{ 0 };	// λţ== pos ʾпд== pos + 1 ʾдɶ
+		AVPacket* pkt = nullptr;		// Ԥݰͨ move_ref 
 		int serial = -1;
+		// ͳ̶߳ȡԪ (ԭӣд̲߳ݾ)
+		std::atomic<int64_t> pts{ AV_NOPTS_VALUE };
+		std::atomic<int> size{ 0 };
+		std::atomic<int64_t> duration{ 0 };	// ðʱķݶ (ʱλ)
+		bool key = false;					// ǷΪؼ֡߶д
 	};
 
-	std::queue<PacketData> queue;
+	// Ĭϻλ (max_packet_count Ϊ 0 ʱʹ)
+	static constexpr size_t DEFAULT_RING_CAPACITY = 1024;
+	// MPEG-TS  33 λʱ
+	static constexpr int64_t TS_WRAP_PERIOD = int64_t(1) << 33;
+
+	std::unique_ptr<PacketSlot[]> m_slots;
+	size_t m_capacity = 0;					// λλ
+
+	std::atomic<size_t> m_head{ 0 };		// λ (ƽ)
+	char m_pad[64] = {};					// дλãα
+	std::atomic<size_t> m_tail{ 0 };		// дλ (ƽ)
+
+	// /ʱĵȴ·
 	mutable std::mutex mutex;				// mutable  const  lock
 	std::condition_variable cond_consumer;	// Ϊʱߵȴ
 	std::condition_variable cond_producer;  // Ϊʱ
-	bool m_block_on_full = false;           // ־true=false=
+	std::atomic<int> m_waiting_consumers{ 0 };	// ڵȴΪ 0 ʱ֪ͨ
+	std::atomic<int> m_waiting_producers{ 0 };	// ڵȴ
+	bool m_block_on_full = false;           // ־true=false=
 
-	std::atomic<bool> eof_signaled{ false };	// ־
+	std::atomic<bool> eof_signaled{ false };	// ־
 	std::atomic<bool> m_abort_request{ false }; // ǿжϱ־
 	
 	// ͳ
-	size_t m_total_bytes = 0;        // packetֽ
+	std::atomic<size_t> m_total_bytes{ 0 };		// packetֽ
+	std::atomic<int64_t> m_total_duration{ 0 };	// packetʱ/ʱά
+	std::atomic<int64_t> m_last_ts{ AV_NOPTS_VALUE };		// Ӱʱ (DTSȣȱʧʱPTS)
+	std::atomic<int64_t> m_last_pkt_duration{ 0 };			// һЧĵʱʱʱ
+
+	// ֱģʽ GOP  (״̬޸ģclear() ʱ)
+	std::atomic<bool> m_seen_keyframe{ false };		// Ƿؼ֡ǵİ˻Ϊ
+	std::atomic<bool> m_skip_to_keyframe{ false };	// Ѷ GOP мİǹؼ֡һ
+	std::atomic<size_t> m_drop_until{ 0 };			// ڶյ㣬ռиλ֮ǰĲλʱҲ붪
+	std::atomic<int64_t> m_resume_pts{ AV_NOPTS_VALUE };	// һ GOP µʼؼ֡ PTS (ȡߵ¼)
+	std::atomic<uint64_t> m_dropped_packets{ 0 };	// ۼƶİ
+	std::atomic<uint64_t> m_drop_events{ 0 };		// ۼƶ¼ (һζ漰)
 
-	// ʱ
-	size_t max_size = 0;             //  (0=)
-	int64_t max_duration_ts = 0;     // ʱ (0=)
+	// ׼ (һ޼Ϊ)
+	size_t max_size = 0;							//  (0=ʹĬϻ)
+	std::atomic<int64_t> max_duration_ts{ 0 };		// 󻺳ʱ (0=)
+	std::atomic<size_t> max_bytes{ 0 };				// 󻺳ֽ (0=)
+	std::atomic<int> m_min_serial{ 0 };				// ʧЧޣкСڸֵİΪɴʣʱ͵ػ
+	std::atomic<bool> m_soft_budget{ false };		// true=ʱ/ֽԤֻΪ㹻жϣֻܻ
+
+	QueueStats m_stats;								// ʱ (ȴʱ䡢ˮλ¡ʱ)
 
 public:
 	/**
 	 * @brief 캯
-	 * @param max_packet_count 0ʾ
-	 * @param max_duration_in_ts 󻺳ʱAVStream->time_baseΪλ0ʾ
-	 * @param block_on_full еԣtrue-ȣfalse-
+	 * @param max_packet_count λĲλ0ʾʹĬ
+	 * @param max_duration_in_ts 󻺳ʱAVStream->time_baseΪλ0ʾ
+	 * @param block_on_full еزԣtrue-ȣfalse-
+	 * @param max_bytes_limit ֽ0ʾ
+	 * ʱֽһޣмΪ block_on_full Դ
+	 * ģʽ GOP Ϊλֱһؼ֡а
+	 * ûкؼ֡µķǹؼֱ֡һؼ֡
 	 */
-	PacketQueue(size_t max_packet_count = 0, int64_t max_duration_in_ts = 0, bool block_on_full = false);
+	PacketQueue(size_t max_packet_count = 0, int64_t max_duration_in_ts = 0, bool block_on_full = false,
+		size_t max_bytes_limit = 0);
 
 	~PacketQueue();
 
 	/**
-	 * @brief ݰͶӦк
+	 * @brief ݰͶӦк
+	 * ݱõԤĲλУԳ packet ԭá
 	 * @param serial ǰĲк
+	 * @return ɹӷ trueжϡEOFֱģʽ¸ðʱ false
 	 */
-	bool push(AVPacket* packet, int serial);
+	bool push(const AVPacket* packet, int serial);
+
+	/**
+	 * @brief ƽʽݰ (㿽)
+	 * packet еͨ av_packet_move_ref ֱλü
+	 * ɹغ packet ΪհAVPacket ṹ屾ԹУֱӸã
+	 * ʧʱ packet ԭɵ߸ unref
+	 * ÷queue->push(std::move(pkt), serial);
+	 */
+	bool push(AVPacket*&& packet, int serial);
 
 	/**
 	 * @brief ȡݰͶӦк
+	 * λеͨ av_packet_move_ref ƽ packetpacket ԭеûȱͷš
 	 * @param serial ظðк
 	 */
 	bool pop(AVPacket* packet, int& serial, int timeout_ms = -1);
 
+	/**
+	 * @brief ȡݰȴһΣȻһȡ max_count Ѿİ
+	 * ֻеһᰴ timeout_ms ȴֻȡǰڶеģ
+	 * ֻȡ󱻻һΣʺƵСƵĳ
+	 * @param packets ṩ max_count ѷ AVPacketԭûȱͷ
+	 * @param serials ÿкţΪ max_count
+	 * @return ʵȡİ0 ʾʱжϻΪEOF
+	 */
+	size_t pop_batch(AVPacket** packets, int* serials, size_t max_count, int timeout_ms = -1);
+
 	size_t size() const;
 
+	/**
+	* @brief  PTS  pts ݰ (̵߳)
+	* Ƶа GOP 󣬽Ƶвüͬʱ㡣
+	*  PTS İֹͣ
+	* @return ʵʶİ
+	*/
+	size_t dropBefore(int64_t pts);
+
+	/**
+	* @brief ȡһ GOP ¼ (̵߳)
+	* @param resume_pts µʼؼ֡ PTS
+	* @return ϴε GOP Чʱ true
+	*/
+	bool takeGopDropEvent(int64_t& resume_pts);
+
+	/**
+	* @brief Ƿڶǹؼ֡ȴһؼ֡ (ֱģʽ)
+	* ڼӦͬµƵʹƵ GOP ¶롣
+	*/
+	bool isSkippingToKeyframe() const;
+
+	/**
+	* @brief ȡۼƶİ붪¼
+	*/
+	uint64_t getDroppedPackets() const;
+	uint64_t getDropEvents() const;
+
+	/**
+	* @brief ȡʱͳƿգʼµˮλͳƴ
+	* ·ʱֻͳƵȴ/·ϵļ
+	*/
+	QueueStatsSnapshot takeStats();
+
+	/**
+	* @brief ʱʱ (ʱΪλ0ʾ)
+	*/
+	void setMaxDuration(int64_t max_duration_in_ts);
+
+	/**
+	* @brief ʱֽ (0ʾ)
+	*/
+	void setMaxBytes(size_t max_bytes_limit);
+
 	/**
 	* @brief ȡеǰʱ (ʱΪλ)
+	* ֵ/ʱάʹ pkt->durationȱʧʱڰʱֵ㣬
+	*  33 λʱƺʱ˴
 	*/
 	int64_t getTotalDuration() const;
 
@@ -89,8 +207,37 @@ public:
 	*/
 	size_t getTotalBytes() const;
 
+	/**
+	* @brief ʱ/ֽԤǷΪԤ
+	* Ԥ push ֻڻλλľʱ/Ԥ hasEnoughPackets()
+	* ϲ㣨 StreamPacketBufferۺ϶·е״̬ʱͣȡ
+	*/
+	void setSoftBudget(bool soft);
+
+	/**
+	* @brief Ƿѻ㹻 (ﵽʱ/ֽԤ)
+	* жϻ EOF ĶҲΪ㹻
+	*/
+	bool hasEnoughPackets() const;
+
+	/**
+	* @brief Ƿٻ min_count Ч (ѴﵽԤ)
+	* ޵жϣֻи·ڸʱ޶ͣȡ
+	* жϻ EOF ĶͬΪ㡣
+	*/
+	bool hasMinimumPackets(size_t min_count) const;
+
+	/**
+	* @brief  O(1) ʹкС serial ݰʧЧ (ʧЧ)
+	* ͷκݰɰ pop ʱ͵ػգ
+	* ҪռʱӶ׻ա֮ǰԼ size()/getTotalBytes() ͳơ
+	* ͬʱ EOF ־ʱ״̬Чͬ clear()̡߳
+	*/
+	void invalidate(int serial);
+
 	/**
 	* @brief նеݰͳϢ
+	* Ҫͷݰͬ/תȹؼ·Ӧʹ invalidate()
 	*/
 	void clear();
 
@@ -111,4 +258,55 @@ public:
 
 	PacketQueue(const PacketQueue&) = delete;
 	PacketQueue& operator=(const PacketQueue&) = delete;
+
+private:
+	// Ƿд
+	bool hasData() const;
+	// дλõĲλǷ
+	bool hasFreeSlot() const;
+	// ٷ incoming_bytes ֽڣǷ񳬳ʱֽԤ (Ϊʱ)
+	bool budgetReached(size_t incoming_bytes) const;
+	// ǷԤƣԤģʽ false
+	bool overBudget(size_t incoming_bytes) const;
+	/**
+	 * @brief ȴģʽڳģʽһдλȷʱ/ֽԤ
+	 * @param incoming ӵİ
+	 * @return λ÷ trueбжϡ EOF򶪰ģʽ¾ incoming ʱ false
+	 */
+	bool reserveSlot(const AVPacket* incoming);
+	// ǷΪʧЧľɴʰ
+	bool hasStaleHead() const;
+	// Ӷ׻ʧЧľɴʰػ
+	size_t purgeStale();
+	/**
+	 * @brief ֱģʽڵȴؼ֡жǷµİ
+	 */
+	bool skipIncoming(const AVPacket* incoming);
+	/**
+	 * @brief ֱģʽʱ GOP ڳռ
+	 * @return ڳռ䷵ trueҪ incoming ʱ false
+	 */
+	bool dropOldestGop(const AVPacket* incoming);
+	// λ end_pos ֮ǰаض
+	size_t dropUntil(size_t end_pos);
+	/**
+	 * @brief 㼴ӵİӦʱķݶʱ״̬
+	 */
+	int64_t estimatePacketDuration(const AVPacket* pkt);
+	/**
+	 * @brief дݵдλòλ
+	 */
+	void publishSlot(int serial);
+	/**
+	 * @brief ռжײλеݰƳ
+	 * ɱߡclear() Լֱģʽ¶ɰͬʱãͨ CAS ֻ֤һɹ
+	 * @param out ݰΪ nullptr ʱֱӶ
+	 * @param end_pos ֻռжλС end_pos Ĳλн綪
+	 * @param notify ȡǷѵȴеߣȡʱɵͳһѣ
+	 * @return ɹȡ trueΪգѵ end_pos false
+	 */
+	bool tryTake(AVPacket* out, int* serial, size_t end_pos = SIZE_MAX, bool notify = true);
+	// ߳ڶӦϵȴ
+	void wakeConsumer();
+	void wakeProducer();
 };
@@ -23,6 +23,29 @@
 #include <atomic>
 #include <string>
 #include <chrono>
+#include <mutex>
+
+#include "QueueStats.h"
+
+// ͳ PlayerDebugStats::queue_stats е±
+enum QueueStatsIndex {
+    QSTATS_VIDEO_PACKET = 0,
+    QSTATS_AUDIO_PACKET,
+    QSTATS_VIDEO_FRAME,
+    QSTATS_AUDIO_FRAME,
+    QSTATS_COUNT
+};
+
+// еʾ (OSD) 뵼 (JSON)
+inline const char* queueStatsLabel(int index) {
+    static const char* const labels[QSTATS_COUNT] = { "V-PKT", "A-PKT", "V-FRM", "A-FRM" };
+    return (index >= 0 && index < QSTATS_COUNT) ? labels[index] : "?";
+}
+
+inline const char* queueStatsKey(int index) {
+    static const char* const keys[QSTATS_COUNT] = { "video_packet", "audio_packet", "video_frame", "audio_frame" };
+    return (index >= 0 && index < QSTATS_COUNT) ? keys[index] : "unknown";
+}
 
 //  FPS 
 class FPSCounter {
@@ -59,6 +82,58 @@ struct PlayerDebugStats {
     std::atomic<int> vq_size{ 0 };
     std::atomic<long long> vq_duration_ms{ 0 };
 
+    // ֱͳ
+    std::atomic<unsigned long long> vq_dropped_pkts{ 0 };  // Ƶۼƶİ
+    std::atomic<unsigned long long> vq_gop_drops{ 0 };     // Ƶа GOP Ĵ
+    std::atomic<unsigned long long> aq_dropped_pkts{ 0 };  // Ƶۼƶİ
+
+    // V-F / A-F (Frame Queue) Info
+    std::atomic<int> vf_size{ 0 };                 // Ƶ֡еδ֡
+    std::atomic<int> vf_capacity{ 0 };             // ڴԤƵ֡
+    std::atomic<unsigned long long> vf_bytes{ 0 }; // Ƶ֡гפڴ (ֽ)
+    std::atomic<unsigned long long> af_bytes{ 0 }; // Ƶ֡гפڴ (ֽ)
+
+    // Ԥ IO Info (δԤʱΪ 0)
+    std::atomic<unsigned long long> io_hits{ 0 };      // ֱԤĴ
+    std::atomic<unsigned long long> io_misses{ 0 };    // ҪȴԤ̵߳Ĵ
+    std::atomic<unsigned long long> io_wait_ms{ 0 };   // ۼƵȴʱ ()
+
+    // תӳ (»ʾ)
+    std::atomic<unsigned long long> seek_count{ 0 };   // ɲת
+    std::atomic<double> seek_last_ms{ 0.0 };           // һתӳ ()
+    std::atomic<double> seek_avg_ms{ 0.0 };            // ƽתӳ ()
+
+    // 
+    std::atomic<int> audio_track{ 0 };        // ǰ ( 1 ʼ)
+    std::atomic<int> audio_track_count{ 0 };  // 
+
+    // ʵʱ˵ӳ (ƽĺδ֪ʱΪ -1)
+    std::atomic<double> live_recv_latency_ms{ -1.0 };   // հʾ
+    std::atomic<double> live_glass_latency_ms{ -1.0 };  // ɼʾ (Ҫṩ NTP ʱ䣬 RTSP  RTCP SR)
+    std::atomic<double> live_lag_ms{ -1.0 };            // յ벥λ֮
+    std::atomic<double> live_target_ms{ 0.0 };          // ׷֡Ŀӳ
+    std::atomic<double> playback_rate{ 1.0 };           // ǰ
+
+    // ʵʱʱ
+    std::atomic<double> timeshift_window_sec{ -1.0 };   // ʱƻ帲ǵʱδʱΪ -1
+    std::atomic<double> timeshift_mb{ 0.0 };            // ʱƻռõڴ
+    std::atomic<bool> timeshifted{ false };             // λ뿪ֱԵ (ͣؿ)
+
+    // ʵʱ¼
+    std::atomic<bool> recording{ false };
+    std::atomic<double> record_mb{ 0.0 };                       // ¼д
+    std::atomic<unsigned long long> record_segments{ 0 };       // ѿʼķֶļ
+    std::atomic<unsigned long long> record_queue_kb{ 0 };       // ȴд
+    std::atomic<unsigned long long> record_dropped_pkts{ 0 };   // д̸϶İ
+    std::atomic<unsigned long long> record_gaps{ 0 };           //  (ÿζһؼ֡)
+
+    // ʵʱ
+    std::atomic<unsigned long long> live_outages{ 0 };              // 
+    std::atomic<unsigned long long> live_reconnect_attempts{ 0 };   // ۼԴ
+    std::atomic<bool> live_reconnecting{ false };                   // 
+    std::atomic<double> live_reconnect_ms{ -1.0 };                  // һʱ޼¼ʱΪ -1
+    std::atomic<double> live_outage_total_ms{ 0.0 };                // ۼʱ
+
     // A-V (Audio Video) Sync
     std::atomic<double> av_diff_ms{ 0.0 };
     std::atomic<double> video_current_pts{ 0.0 };
@@ -67,6 +142,17 @@ struct PlayerDebugStats {
     // Clock Source (0: Audio, 1: External)
     std::atomic<int> clock_source_type{ 0 }; 
 
+    // Ƶ߳ (decode_thread_type Ϊ DecoderThreadType ȡֵ)
+    std::atomic<int> decode_threads{ 0 };
+    std::atomic<int> decode_thread_type{ 0 };
+
+    // δʾƵ֡ٵ׼úʾǰһ֡
+    std::atomic<unsigned long long> render_dropped_frames{ 0 };
+
+    // ǰ֡ (ȼ FrameSkipController)
+    std::atomic<int> frame_skip_level{ 0 };
+    std::atomic<unsigned long long> frame_skip_escalations{ 0 };
+
     // FPS
     FPSCounter decode_fps;
     FPSCounter render_fps;
@@ -74,4 +160,11 @@ struct PlayerDebugStats {
     // ״̬
     // 0:IDLE, 1:BUFFERING, 2:PLAYING, 3:PAUSED, 4:STOPPED
     std::atomic<int> current_state{ 0 };
+
+    // еͳƿ (ɿ̶߳ڷд queue_stats_mutex)
+    mutable std::mutex queue_stats_mutex;
+    QueueStatsSnapshot queue_stats[QSTATS_COUNT];
+
+    // OSD ҳ (0: , 1: ͳ)
+    std::atomic<int> osd_page{ 0 };
 };
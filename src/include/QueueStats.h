@@ -0,0 +1,198 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+
+// ȴʱֱͼͰͰ (΢)  QUEUE_WAIT_BUCKET_LIMITS_USһͰ
+constexpr int QUEUE_WAIT_BUCKETS = 5;
+constexpr unsigned long long QUEUE_WAIT_BUCKET_LIMITS_US[QUEUE_WAIT_BUCKETS - 1] = { 100, 1000, 10000, 100000 };
+
+// ĳһʱ̵Ķͳƿ (ͨݣɿ)
+struct QueueStatsSnapshot {
+    size_t size = 0;                    // ǰԪ
+    size_t capacity = 0;                //  (Ԫ)
+    size_t high_watermark = 0;          // ͳƴڵˮλ
+    size_t low_watermark = 0;           // ͳƴڵˮλ
+
+    unsigned long long pushes = 0;      // ۼӴ
+    unsigned long long pops = 0;        // ۼƳӴ
+    unsigned long long drops = 0;       // ۼƶ (ֱģʽ)
+
+    unsigned long long producer_waits = 0;      // 
+    unsigned long long producer_wait_us = 0;    // ۼʱ (΢)
+    unsigned long long producer_wait_hist[QUEUE_WAIT_BUCKETS] = {};
+    unsigned long long consumer_waits = 0;      // 
+    unsigned long long consumer_wait_us = 0;    // ۼʱ (΢)
+    unsigned long long consumer_wait_hist[QUEUE_WAIT_BUCKETS] = {};
+
+    unsigned long long lock_holds = 0;          // ʱļ
+    unsigned long long lock_hold_us = 0;        // ۼƳʱ (΢)
+    unsigned long long lock_hold_max_us = 0;    // ͳƴһγʱ (΢)
+
+    // ɷοռ
+    double push_rate = 0.0;             // ÿӴ
+    double pop_rate = 0.0;              // ÿӴ
+
+    // Ե JSON ʽ־ɼ
+    void writeJson(std::ostream& os) const {
+        os << "{\"size\":" << size << ",\"capacity\":" << capacity
+            << ",\"high\":" << high_watermark << ",\"low\":" << low_watermark
+            << ",\"pushes\":" << pushes << ",\"pops\":" << pops << ",\"drops\":" << drops
+            << ",\"push_rate\":" << push_rate << ",\"pop_rate\":" << pop_rate
+            << ",\"producer_wait\":";
+        writeWaitJson(os, producer_waits, producer_wait_us, producer_wait_hist);
+        os << ",\"consumer_wait\":";
+        writeWaitJson(os, consumer_waits, consumer_wait_us, consumer_wait_hist);
+        os << ",\"lock\":{\"count\":" << lock_holds << ",\"total_us\":" << lock_hold_us
+            << ",\"max_us\":" << lock_hold_max_us << "}}";
+    }
+
+private:
+    static void writeWaitJson(std::ostream& os, unsigned long long count, unsigned long long total_us,
+        const unsigned long long (&hist)[QUEUE_WAIT_BUCKETS]) {
+        os << "{\"count\":" << count << ",\"total_us\":" << total_us << ",\"hist\":[";
+        for (int i = 0; i < QUEUE_WAIT_BUCKETS; ++i) {
+            os << (i ? "," : "") << hist[i];
+        }
+        os << "]}";
+    }
+};
+
+/**
+ * еʱ PacketQueue / FrameQueue ڲά
+ * мΪ relaxed ԭӲֻ/ӳɹ߳ʵԼʱ£
+ * ·ͬ
+ */
+class QueueStats {
+private:
+    std::atomic<unsigned long long> m_pushes{ 0 };
+    std::atomic<unsigned long long> m_pops{ 0 };
+    std::atomic<size_t> m_high_watermark{ 0 };
+    std::atomic<size_t> m_low_watermark{ std::numeric_limits<size_t>::max() };
+
+    std::atomic<unsigned long long> m_producer_waits{ 0 };
+    std::atomic<unsigned long long> m_producer_wait_us{ 0 };
+    std::atomic<unsigned long long> m_producer_wait_hist[QUEUE_WAIT_BUCKETS] = {};
+    std::atomic<unsigned long long> m_consumer_waits{ 0 };
+    std::atomic<unsigned long long> m_consumer_wait_us{ 0 };
+    std::atomic<unsigned long long> m_consumer_wait_hist[QUEUE_WAIT_BUCKETS] = {};
+
+    std::atomic<unsigned long long> m_lock_holds{ 0 };
+    std::atomic<unsigned long long> m_lock_hold_us{ 0 };
+    std::atomic<unsigned long long> m_lock_hold_max_us{ 0 };
+
+    static int bucketOf(unsigned long long us) {
+        int i = 0;
+        while (i < QUEUE_WAIT_BUCKETS - 1 && us >= QUEUE_WAIT_BUCKET_LIMITS_US[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static Clock::time_point now() { return Clock::now(); }
+
+    static unsigned long long elapsedUs(Clock::time_point since) {
+        return static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count());
+    }
+
+    // ɹӣsize_after ΪӺԪ
+    void onPush(size_t size_after) {
+        m_pushes.fetch_add(1, std::memory_order_relaxed);
+        size_t high = m_high_watermark.load(std::memory_order_relaxed);
+        while (size_after > high &&
+            !m_high_watermark.compare_exchange_weak(high, size_after, std::memory_order_relaxed)) {
+        }
+    }
+
+    // ɹӣsize_after ΪӺԪ
+    void onPop(size_t size_after) {
+        m_pops.fetch_add(1, std::memory_order_relaxed);
+        size_t low = m_low_watermark.load(std::memory_order_relaxed);
+        while (size_after < low &&
+            !m_low_watermark.compare_exchange_weak(low, size_after, std::memory_order_relaxed)) {
+        }
+    }
+
+    //  / ʵһΣsince Ϊʼȴʱ
+    void onProducerWait(Clock::time_point since) {
+        unsigned long long us = elapsedUs(since);
+        m_producer_waits.fetch_add(1, std::memory_order_relaxed);
+        m_producer_wait_us.fetch_add(us, std::memory_order_relaxed);
+        m_producer_wait_hist[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void onConsumerWait(Clock::time_point since) {
+        unsigned long long us = elapsedUs(since);
+        m_consumer_waits.fetch_add(1, std::memory_order_relaxed);
+        m_consumer_wait_us.fetch_add(us, std::memory_order_relaxed);
+        m_consumer_wait_hist[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // һγsince Ϊȡ (ȴ) ʱ
+    void onLockHold(Clock::time_point since) {
+        unsigned long long us = elapsedUs(since);
+        m_lock_holds.fetch_add(1, std::memory_order_relaxed);
+        m_lock_hold_us.fetch_add(us, std::memory_order_relaxed);
+        unsigned long long max_us = m_lock_hold_max_us.load(std::memory_order_relaxed);
+        while (us > max_us &&
+            !m_lock_hold_max_us.compare_exchange_weak(max_us, us, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief ȡǰ (size/capacity/drops ɶд)
+     * ˮλʱڶȡãʼµͳƴڡ
+     */
+    QueueStatsSnapshot takeSnapshot(size_t current_size) {
+        QueueStatsSnapshot s;
+        s.size = current_size;
+        s.pushes = m_pushes.load(std::memory_order_relaxed);
+        s.pops = m_pops.load(std::memory_order_relaxed);
+
+        size_t high = m_high_watermark.exchange(current_size, std::memory_order_relaxed);
+        size_t low = m_low_watermark.exchange(current_size, std::memory_order_relaxed);
+        s.high_watermark = high > current_size ? high : current_size;
+        s.low_watermark = low < current_size ? low : current_size;
+
+        s.producer_waits = m_producer_waits.load(std::memory_order_relaxed);
+        s.producer_wait_us = m_producer_wait_us.load(std::memory_order_relaxed);
+        s.consumer_waits = m_consumer_waits.load(std::memory_order_relaxed);
+        s.consumer_wait_us = m_consumer_wait_us.load(std::memory_order_relaxed);
+        for (int i = 0; i < QUEUE_WAIT_BUCKETS; ++i) {
+            s.producer_wait_hist[i] = m_producer_wait_hist[i].load(std::memory_order_relaxed);
+            s.consumer_wait_hist[i] = m_consumer_wait_hist[i].load(std::memory_order_relaxed);
+        }
+
+        s.lock_holds = m_lock_holds.load(std::memory_order_relaxed);
+        s.lock_hold_us = m_lock_hold_us.load(std::memory_order_relaxed);
+        s.lock_hold_max_us = m_lock_hold_max_us.exchange(0, std::memory_order_relaxed);
+        return s;
+    }
+};
@@ -0,0 +1,147 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+extern "C" {
+#include <libavformat/avio.h>
+#include <libavutil/error.h>	// AVERROR
+#include <libavutil/mem.h>		// av_malloc
+}
+
+// Ԥͳ (ȡʱĿ)
+struct ReadAheadStats {
+	uint64_t hits = 0;				// ʱݵĴ
+	uint64_t misses = 0;			// ҪȴԤ̵߳Ĵ
+	uint64_t miss_wait_us = 0;		// ۼƵȴʱ (΢)
+	uint64_t seeks_in_buffer = 0;	// Ŀλڻ崰ڡ¶ȡ seek 
+	uint64_t seeks_refill = 0;		// ʹʧЧҪײ seek Ĵ
+	uint64_t bytes_prefetched = 0;	// Ԥ̴߳ӵײȡֽ
+	uint64_t bytes_read = 0;		// װֽ
+};
+
+/**
+ * ̨Ԥ̵߳ AVIOContext
+ * ײͨ avio_open2 򿪣ļHTTP  avio Э飩ɶ̳߳һλ壬
+ * װͨ getAVIOContext() õֻӻȡݣ av_read_frame ֱڴ̻ϡ
+ * λ屣Ѷһݣڻ崰ڵ seekСˣֱУ
+ *  seek ʹʧЧԤִ߳еײ seek 䡣
+ * ص seek صֻڽװ߳бá
+ */
+class ReadAheadIOContext {
+private:
+	// Ԥ߳ÿδӵײȡֽ
+	static constexpr size_t PREFETCH_CHUNK_SIZE = 256 * 1024;
+	//  avio_alloc_context ڲС
+	static constexpr int IO_BUFFER_SIZE = 64 * 1024;
+
+	AVIOContext* m_inner = nullptr;			// ײ avio  (Ԥ߳ڼ)
+	AVIOContext* m_outer = nullptr;			//  AVFormatContext Զ
+	int64_t m_file_size = -1;				// ײԴС (δ֪Ϊ -1)
+
+	std::vector<uint8_t> m_ring;			// λ壬ļλ pos λ m_ring[pos % ]
+	size_t m_back_reserve = 0;				// Ϊ seek Ѷ
+
+	// ״̬ m_mutex λþΪײԴеֽƫ
+	int64_t m_window_start = 0;				// 崰 (ȻЧ)
+	int64_t m_read_pos = 0;					// װĶλ
+	int64_t m_fill_pos = 0;					// Ԥ̵߳дλ (յ)
+	int64_t m_seek_target = -1;				// Ԥִ߳еĵײ seek Ŀ (-1=)
+	uint64_t m_generation = 0;				// ÿʹʧЧʱڶڵԤ
+	bool m_eof = false;						// ײѶβ
+	int m_error = 0;						// ײȡ (0=)
+	bool m_stop = false;					// Ԥ߳˳
+	bool m_filler_waiting = false;			// Ԥ߳Ƿڵȴռ
+
+	std::atomic<bool> m_abort{ false };		// ж󣺶ص
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cond_reader;	// صȴ
+	std::condition_variable m_cond_filler;	// Ԥ̵߳ȴռ seek 
+	std::thread m_thread;
+
+	ReadAheadStats m_stats;					//  m_mutex 
+
+public:
+	/**
+	 * @param read_ahead_bytes λСֽڣԼķ֮һڱѶ
+	 */
+	explicit ReadAheadIOContext(size_t read_ahead_bytes);
+	~ReadAheadIOContext();
+
+	/**
+	 * @brief 򿪵ײԴԤ߳
+	 * @param url · avio ֵ֧ URL
+	 * @param int_cb жϻصײ avio_open2Ϊ nullptr
+	 * @return ɹ 0ʧܷ FFmpeg 
+	 */
+	int open(const char* url, const AVIOInterruptCB* int_cb);
+
+	/**
+	 * @brief ֹͣԤ̲߳ͷԴ avformat_close_input ֮
+	 */
+	void close();
+
+	/**
+	 * @brief жڵȴݵĶص (abort=false ʱָ)
+	 */
+	void requestAbort(bool abort);
+
+	/**
+	 * @brief ԤδݣλԤλ (ֱ׷֡ʱջѹ)
+	 */
+	void discardBuffered();
+
+	/**
+	 * @brief ȡ AVFormatContext::pb 
+	 */
+	AVIOContext* getAVIOContext() const { return m_outer; }
+
+	/**
+	 * @brief ȡԤͳƿ
+	 */
+	ReadAheadStats getStats() const;
+
+	/**
+	 * @brief ж URL ǷʺԤ (ļfile/http/https Э)
+	 */
+	static bool isSupported(const char* url);
+
+	ReadAheadIOContext(const ReadAheadIOContext&) = delete;
+	ReadAheadIOContext& operator=(const ReadAheadIOContext&) = delete;
+
+private:
+	// AVIOContext ص (ڽװ߳е)
+	static int readCallback(void* opaque, uint8_t* buf, int buf_size);
+	static int64_t seekCallback(void* opaque, int64_t offset, int whence);
+
+	int read(uint8_t* buf, int buf_size);
+	int64_t seek(int64_t offset, int whence);
+
+	// Ԥ߳ѭ
+	void prefetchLoop();
+};
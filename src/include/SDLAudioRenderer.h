@@ -21,9 +21,11 @@
 #pragma once
 
 #include "IAudioRenderer.h"
+#include "AudioTempoFilter.h"
 #include <SDL2/SDL.h>
 #include <mutex>
 #include <atomic>
+#include <vector>
 
 // ǰ FFmpeg 
 extern "C" {
@@ -43,9 +45,12 @@ public:
     bool init(int sampleRate, int channels, enum AVSampleFormat decoderSampleFormat,
         AVRational timeBase, IClockManager* clockManager) override;
     bool renderFrame(AVFrame* frame, const std::atomic<bool>& quit) override;
+    bool renderFrames(AVFrame** frames, int count, const std::atomic<bool>& quit) override;
     void play() override;
     void pause() override;
     void flushBuffers() override;
+    void setLowLatency(bool enable) override;
+    void setPlaybackRate(double rate) override;
     void close() override;
 
 private:
@@ -57,10 +62,33 @@ private:
     uint8_t* m_resampled_buffer = nullptr;      // زݻ
     unsigned int m_resampled_buffer_size = 0;   // С
 
+    // ȷز size ֽڣݻᱻ
+    bool ensureBufferSize(int size);
+    //  () ز豸ʽһʱʹز
+    // л֡Ĳ//ʽܸı䣬Ⱦʱݴ
+    bool configureResampler(int sampleRate, int channels, enum AVSampleFormat sampleFormat);
+
+    // ǰƵ
+    int m_in_sample_rate = 0;
+    int m_in_channels = 0;
+    enum AVSampleFormat m_in_sample_fmt = AV_SAMPLE_FMT_NONE;
+
     // ĿƵ
     int m_target_channels = 0;
     enum AVSampleFormat m_target_sample_fmt = AV_SAMPLE_FMT_S16;
 
+    // Ŷлѹ ()ʱȾ̵߳ȴֹڴĲӿתӦ
+    static constexpr double MAX_QUEUED_SEC = 1.5;
+    static constexpr double LOW_LATENCY_MAX_QUEUED_SEC = 0.05;  // ӳģʽ
+    bool m_low_latency = false;
+
+    // ٣״ƫ 1.0 ʱ atempo ˾˺ݶ (ֻȾ߳з)
+    std::atomic<double> m_playback_rate{ 1.0 };
+    std::atomic<bool> m_tempo_reset_pending{ false };  // flushBuffers() ˾л
+    AudioTempoFilter m_tempo_filter;
+    bool m_tempo_unavailable = false;                   // ˾ʧܺԣʼհԭٲ
+    std::vector<uint8_t> m_tempo_buffer;                // ٺ
+
     // ͬ
     IClockManager* m_clock_manager = nullptr;
     AVRational m_time_base;
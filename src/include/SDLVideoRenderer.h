@@ -27,6 +27,8 @@
 #include <string>
 #include <iostream>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include "SDL2/SDL.h"
 
@@ -34,15 +36,56 @@ extern "C" {
 #include <libavutil/rational.h>
 #include <libswscale/swscale.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>  // av_get_pix_fmt_name()
 }
 
 class SDLVideoRenderer : public IVideoRenderer {
 private:
+    // ̵߳ȴ̨ʱ (߳̿סʱһ֡Ⱦ߳)
+    static constexpr int SLOT_WAIT_TIMEOUT_MS = 100;
+
+    // λ֡ݵԴ
+    enum class SlotSource {
+        NONE,       // û
+        DIRECT,     // direct бԴ֡ãϴʱֱʹýƽ
+        LOCKED,     // תڴУϴ
+        BUFFER      // δʱת buffer Уϴʱ
+    };
+
+    // λ״̬ ( m_swap_mutex ¶д)
+    enum class SlotState {
+        MAIN,       // ̣߳ʾ (front)ڱ߳׼
+        FREE,       // ̨λУ߳̿
+        FILLING,    // ߳
+        READY,      // 䣬ȴ߳ϴ߳Ҳøµ֡
+        CONSUMING   // ߳ϴ
+    };
+
+    // ˫λ߳ʾ front߳һ (back)
+    struct TextureSlot {
+        SDL_Texture* texture = nullptr;
+        SlotState state = SlotState::MAIN;
+        SlotSource source = SlotSource::NONE;
+        bool full_range = false;    // ΪȫΧ (JPEG) YUVʾʱл SDL  YUV תģʽ
+        bool locked = false;        // Ƿѱ߳ (pixels/pitch Ч)
+        void* pixels = nullptr;
+        int pitch = 0;
+        AVFrame* direct = nullptr;  // ֱϴԴ֡ ()
+        AVFrame* buffer = nullptr;  // δʱת (ʽ)
+    };
+
     SDL_Window* m_window = nullptr;
     SDL_Renderer* m_renderer = nullptr;
-    SDL_Texture* m_texture = nullptr;
-    SwsContext* m_sws_context = nullptr;
-    AVFrame* m_yuv_frame = nullptr;
+    TextureSlot m_slots[2];
+    int m_front = 0;                            // ʾĲλ (ֻ߳ m_swap_mutex ޸)
+    std::mutex m_swap_mutex;                    // ֻλ״̬Ľӣתϴڼ
+    std::condition_variable m_swap_cond;
+    std::atomic<bool> m_convert_active{ false }; // ֡Ҫת߳Ԥ̨߳д
+    enum AVPixelFormat m_texture_format = AV_PIX_FMT_YUV420P; // Ӧظʽ (YUV420P / NV12 / NV21)
+    SwsContext* m_sws_context = nullptr;        // Դ֡޷ֱϴʱ贴 (ֻɹ߳ʹ)
+    int m_last_source_format = AV_PIX_FMT_NONE; // һ֡Դʽ (ʽ仯ʱ־)
+    unsigned int m_overwritten_frames = 0;      // δʾͱǵ֡ (ֻɹ̷߳)
+    SDL_YUV_CONVERSION_MODE m_default_yuv_mode = SDL_YUV_CONVERSION_BT601; // ޷Χʹõתģʽ (ʼʱȫ)
 
     IClockManager* m_clock_manager = nullptr;
     AVRational m_time_base;         // ƵʱPTS
@@ -60,8 +103,8 @@ private:
     bool m_is_audio_only = false;   // ǷΪƵģʽ
     bool m_is_live_stream = false;  // ǷΪֱ
 
-    std::mutex m_mutex;                         // ڱSDLԴķ
-    AVFrame* m_last_rendered_frame = nullptr;   // һ֡ĸˢºͻָ
+    std::mutex m_mutex;                         // ڱ߳жSDLԴķ (̲߳ٻȡ)
+    bool m_has_frame = false;                   // front ǷпػĻ
     
     bool m_first_frame_after_reset = true;      // ڴ Reset һ֡߼
 
@@ -75,6 +118,21 @@ private:
     // OSDԲ
     void renderOSD();
 
+    // λʹõ
+    SDL_Texture* createTexture(Uint32 format);
+    // Դܷ֡񲻾תֱϴ
+    bool canUploadDirectly(const AVFrame* frame) const;
+    // Դ֡תΪʽдλڴת
+    bool convertFrame(const AVFrame* frame, TextureSlot& slot);
+    // λݵɫʷΧ SDL  YUV תģʽ (̣߳RenderCopy ֮ǰ)
+    void applyYUVConversionMode(const TextureSlot& slot);
+    // Ӳλ֡ϴ (DIRECT / BUFFER)
+    int uploadSlot(TextureSlot& slot);
+    // ȡĺ̨λϴ front Ƿ» (߳)
+    bool swapInReadySlot();
+    // ׼µĺ̨λ () ߳ (߳)
+    void releaseBackSlot();
+
 public:
     SDLVideoRenderer() = default;
     virtual ~SDLVideoRenderer();
@@ -94,7 +152,7 @@ public:
     void setStreamType(bool isLive) override;
 
     // Ⱦ߼ط
-    double calculateSyncDelay(AVFrame* frame) override;
+    double calculateSyncDelay(AVFrame* frame, const AVFrame* next_frame = nullptr) override;
     bool prepareFrameForDisplay(AVFrame* frame) override;
     void displayFrame() override; // ߳е
 
@@ -105,4 +163,5 @@ public:
     void getWindowSize(int& width, int& height) const override;
 
     void flush() override;
+    unsigned int takeOverwrittenFrames() override;
 };
@@ -0,0 +1,114 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "PacketQueue.h"
+
+/**
+ * ·֯ݰ塣
+ * װֻ߳һߣȴҪƵ PacketQueue д룻жʱ
+ * ֯ļ֡ƵƵȴѶա
+ * Ѹ· PacketQueue Ϊֵͼͳһ
+ *  - ͼΪԤ㣬push ֻڻλλľʱ·Ԥ㿨ס
+ *  - ֻелѻ㹻 (hasEnoughPackets) ʱװ̲߳ waitWhileEnough()
+ *    ͣȡ ( ffplay  "enough packets" ж)
+ *  - ֽʱֻи·ͻ (MIN_PACKETS) ͣ
+ *    ȡιһ··ɸԵĻⶥ
+ * бԹУָֻ롣
+ */
+class StreamPacketBuffer {
+private:
+	struct StreamView {
+		int stream_index = -1;
+		PacketQueue* queue = nullptr;
+	};
+
+	std::vector<StreamView> m_streams;
+	size_t m_max_total_bytes = 0;			// ϼƵֽ (0=)
+	static constexpr size_t MIN_PACKETS = 25;	// ʱÿһ·ٱİ޶
+
+	std::mutex m_mutex;
+	std::condition_variable m_cond_reader;	// װ߳ڡ㹻ʱڴ˵ȴ
+	std::atomic<bool> m_abort_request{ false };
+
+public:
+	/**
+	 * @param max_total_bytes ϼƵĻֽޣҸ·ͻʱͣȡ0ʾ
+	 */
+	explicit StreamPacketBuffer(size_t max_total_bytes = 0);
+
+	/**
+	 * @brief עһ·ݰУöΪԤ
+	 */
+	void addStream(int stream_index, PacketQueue* queue);
+
+	/**
+	 * @brief ȡĳһ·ӦĶͼδעʱ nullptr
+	 */
+	PacketQueue* getStream(int stream_index) const;
+
+	/**
+	 * @brief עһ·иΪһ (лʱʹ)еݰֲ
+	 * @return old_stream_index δעʱ false
+	 */
+	bool remapStream(int old_stream_index, int new_stream_index);
+
+	/**
+	 * @brief  packet->stream_index ַӦ (ƽʽ)
+	 * @return ɹӷ trueδעоܾʱ falsepacket ԭ
+	 */
+	bool push(AVPacket*&& packet, int serial);
+
+	/**
+	 * @brief Ƿѻ㹻л㹻ֽûһ·ͻ
+	 */
+	bool isEnough() const;
+
+	/**
+	 * @brief ڻ㹻ʱͣȡֱҪݡ wake()/abort() ѻʱ
+	 * еĳӲ֪ͨ࣬Խ϶̵ĳʱѯ
+	 * @return жʱ false
+	 */
+	bool waitWhileEnough(int timeout_ms);
+
+	/**
+	 * @brief ͣеĽװ߳ (ͬתҪȡĳ)
+	 */
+	void wake();
+
+	/**
+	 * @brief жϵȴڳ˳
+	 */
+	void abort();
+
+	/**
+	 * @brief ȡϼƵĻֽ
+	 */
+	size_t getTotalBytes() const;
+
+	StreamPacketBuffer(const StreamPacketBuffer&) = delete;
+	StreamPacketBuffer& operator=(const StreamPacketBuffer&) = delete;
+};
@@ -0,0 +1,161 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+// ¼ͳ (ȡʱĿ)
+struct RecorderStats {
+	bool recording = false;				// Ƿڽ
+	uint64_t packets_written = 0;		// дļİ
+	uint64_t bytes_written = 0;			// дļĸֽ
+	uint64_t packets_dropped = 0;		// İ
+	uint64_t gaps = 0;					// µĶ (ÿζһؼ֡Ϊֹ)
+	uint64_t segments = 0;				// ѿʼķֶļ
+	size_t queued_bytes = 0;			// еȴдֽ
+	std::string current_file;			// дļ
+};
+
+/**
+ * ̨¼ƣѽװ̶߳İתװ (remux) Ϊ MP4/MKV ֶļ롢±롣
+ * װ̵߳ submit() Ѱ (벥ŹݣƸ) ¼ԼнУ
+ * ɶд̰߳ؼ֡зļд̡submit() Ӳгֽʱ
+ * µİֱһؼ֡ʹʱζ GOPļеÿһԿԶ롣
+ * Ĳ start() ʱƣд̲߳ʽ⸴
+ */
+class StreamRecorder {
+private:
+	// һ·¼Ƶ
+	struct OutputStream {
+		int input_index;				// 
+		AVCodecParameters* codecpar;	// ʼ¼ʱƵı
+		AVRational time_base;			// ʱ
+	};
+
+	std::string m_format;				//  ("mp4"  "matroska")
+	std::string m_path_prefix;			// ļǰ׺
+	double m_segment_sec;				// ֶʱ (0=ֶ)
+	size_t m_max_queue_bytes;			// ֽ
+
+	std::vector<OutputStream> m_streams;
+	int m_key_stream = -1;				// ڶֶ붪 (ƵʱΪƵ)
+	std::string m_file_stem;			// ¼Ƶļ (ǰ׺ + ʼʱ)
+
+	// ״̬ m_mutex 
+	struct QueuedPacket {
+		AVPacket* packet;
+		bool keyframe;					// key_stream ϵĹؼ֡Ϊֶ
+		bool discontinuity;				// жϺĵһؼ֡ʼµķֶ
+	};
+	std::deque<QueuedPacket> m_queue;
+	size_t m_queued_bytes = 0;
+	bool m_skip_to_keyframe = true;		// µİֱһؼ֡ (ʼ¼ʱҲӹؼ֡ʼ)
+	bool m_waiting_first_keyframe = true;	// δյһؼ֡ʱĶͳ
+	bool m_discontinuity = false;		// жϣһؼ֡ʼµķֶ
+	bool m_stop = false;				// д߳дк
+	bool m_writer_done = true;			// д߳ѹرļ˳ѭػ
+	RecorderStats m_stats;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::thread m_thread;
+
+	// ״ֻ̬д߳з
+	AVFormatContext* m_output = nullptr;
+	double m_segment_start = 0.0;		// ǰֶεһؼ֡ʱ ()
+	std::vector<int64_t> m_ts_offsets;	// ·ȥʱƫƣʹÿֶδ 0 ʼ
+	bool m_write_error_logged = false;
+
+public:
+	/**
+	 * @param format  ( avformat_alloc_output_context2 "mp4""matroska")
+	 * @param path_prefix ļǰ׺ļΪ ǰ׺ + ʼʱ + ֶ + չ
+	 * @param segment_sec ֶʱ ()һؼ֡лļ0 ʾֶ
+	 * @param max_queue_bytes деֽޣʱ GOP 
+	 */
+	StreamRecorder(const std::string& format, const std::string& path_prefix, double segment_sec, size_t max_queue_bytes);
+	~StreamRecorder();
+
+	/**
+	 * @brief ʼ¼ (ɽװ̵߳)Ƹ·Ĳд̡߳
+	 * һ¼Ƶд߳дʱȴֱӷ falseɵԺ
+	 * @param input Ѵ򿪵
+	 * @param stream_indices Ҫ¼Ƶ
+	 * @param key_stream ڶֶ붪ͨΪƵֻ¼ƵʱƵ
+	 */
+	bool start(const AVFormatContext* input, const std::vector<int>& stream_indices, int key_stream);
+
+	/**
+	 * @brief ֹͣµİ ()д߳деݺرļ
+	 * һ start() ʱ
+	 */
+	void stop();
+
+	bool isRecording() const;
+
+	/**
+	 * @brief ֹͣգд߳де
+	 */
+	bool isFlushing() const;
+
+	/**
+	 * @brief ύһ (ɽװ̵߳ãӲ)ֻü߱ԭã
+	 * ¼ƷΧڵֱӺ
+	 * @param keyframe ðǷΪɶĹؼ֡ (ֻ key_stream )
+	 */
+	void submit(const AVPacket* packet, bool keyframe);
+
+	/**
+	 * @brief Ĳ (ʵʱʱ¿ʼ)
+	 * ֮İֱһؼ֡ (붪ͳ)Ӹùؼ֡ʼµķֶļ
+	 */
+	void markDiscontinuity();
+
+	/**
+	 * @brief ȡ¼ͳƿ
+	 */
+	RecorderStats getStats() const;
+
+	StreamRecorder(const StreamRecorder&) = delete;
+	StreamRecorder& operator=(const StreamRecorder&) = delete;
+
+private:
+	// д߳ѭ
+	void writeLoop();
+	//  start_ts (AV_TIME_BASE λ key_stream ʱ) Ϊһֶļдļͷ
+	bool openSegment(int64_t start_ts);
+	// дļβرյǰֶ
+	void closeSegment();
+	// һд뵱ǰֶ (д packet )
+	void writePacket(AVPacket* packet, const OutputStream& stream, size_t output_index);
+	// ȴд߳̽ͷŸƵı
+	void joinWriter();
+};
@@ -0,0 +1,136 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>	// AVPacket
+}
+
+/**
+ * ʵʱʱƻ (Timeshift)
+ * յ˳򱣴ݰã벥ŶеİͬһݣƸأ
+ * ʱֽΪޣʱɵһ˰ GOP ̭֤Ǵӹؼ֡ʼ
+ * ֽӲޣûһؼ֡ɹ̭ʱ ( intra-refresh )̭
+ * дΨһ GOP ֽʱ֮ķǹؼֱ֡һؼ֡
+ * αָһҪ벥Ŷеİͣʱαͣס¼ճУָα괦ͳ
+ * ؿʱαƵڵĹؼ֡ϣصֱʱƵµĹؼ֡
+ * ֻɽװ̷߳ʣ
+ */
+class TimeshiftBuffer {
+private:
+	struct Entry {
+		AVPacket* packet;
+		double time;		// ʱ ()ûʱʱǰһʱ
+		bool keyframe;		// Ϊת (Ƶ IDRƵÿ)
+	};
+
+	std::deque<Entry> m_entries;
+	std::deque<uint64_t> m_keyframes;		// ڹؼ֡ţʱ
+	std::vector<AVPacket*> m_spare;			// ̭õ AVPacket ṹ壬ÿ
+	uint64_t m_first_seq = 0;				// m_entries.front() 
+	uint64_t m_cursor = 0;					// һҪİ
+	size_t m_bytes = 0;
+	double m_last_time = 0.0;
+	bool m_overrun = false;
+	bool m_skip_to_keyframe = false;		// Ψһ GOP ѳֽޣշǹؼֱ֡һؼ֡
+
+	double m_max_duration_sec;
+	size_t m_max_bytes;
+
+public:
+	/**
+	 * @param max_duration_sec ʱ ()
+	 * @param max_bytes ĸֽ
+	 */
+	TimeshiftBuffer(double max_duration_sec, size_t max_bytes);
+	~TimeshiftBuffer();
+
+	/**
+	 * @brief ¼һ (ü߱ԭ)Ҫʱ GOP ̭ɵ
+	 * @param time_sec ʱ ()δ֪ʱ NaN
+	 * @param keyframe ǷԴӸðʼ
+	 * @return ¼뷵 trueΨһ GOP ֽ޶շǹؼ֡ʱ false
+	 */
+	bool append(const AVPacket* packet, double time_sec, bool keyframe);
+
+	/**
+	 * @brief α괦Ƿδİ (α׷ʱ false)
+	 */
+	bool hasPending() const { return m_cursor < m_first_seq + m_entries.size(); }
+
+	/**
+	 * @brief α괦İûδİʱ -1
+	 */
+	int peekStreamIndex() const;
+
+	/**
+	 * @brief α괦İ (packet һµã屣ԭԱؿ) ǰα
+	 */
+	bool read(AVPacket* packet);
+
+	/**
+	 * @brief αƵʱ䲻 time_sec һؼ֡ڴʱڴڵһؼ֡
+	 * @return ʱ ()ڻûйؼ֡ʱ NaN α겻
+	 */
+	double seek(double time_sec);
+
+	/**
+	 * @brief αƵµĹؼ֡ (صֱ)
+	 * @return ʱ ()ûйؼ֡ʱ NaN α겻
+	 */
+	double seekToLatestKeyframe();
+
+	/**
+	 * @brief ȡߡαָѱ̭¼
+	 * ͣؿãǰԽαʱαѱƵڵĵһؼ֡
+	 * ҪתһʼµĲ
+	 */
+	bool takeOverrun();
+
+	// ڷΧռ
+	double getStartTime() const;
+	double getEndTime() const;
+	double getDuration() const;
+	size_t getBytes() const { return m_bytes; }
+	size_t size() const { return m_entries.size(); }
+
+	/**
+	 * @brief ͷݣαص
+	 */
+	void clear();
+
+	TimeshiftBuffer(const TimeshiftBuffer&) = delete;
+	TimeshiftBuffer& operator=(const TimeshiftBuffer&) = delete;
+
+private:
+	// ̭׵İ
+	void popFront();
+	// ʱ/ֽʱӶװ GOP ̭ (ûйؼ֡ʱ̭Ψһ GOP ʱתΪշǹؼ֡)
+	void evict();
+	// αƵ index ؼ֡ʱ
+	double moveCursorToKeyframe(size_t index);
+	const Entry& entryAt(uint64_t seq) const { return m_entries[static_cast<size_t>(seq - m_first_seq)]; }
+};
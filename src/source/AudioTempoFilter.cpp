@@ -0,0 +1,170 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/AudioTempoFilter.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>	// memcpy
+
+extern "C" {
+#include <libavfilter/buffersrc.h>
+#include <libavfilter/buffersink.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/error.h>
+#include <libavutil/frame.h>
+}
+
+using namespace std;
+
+AudioTempoFilter::~AudioTempoFilter() {
+	close();
+}
+
+bool AudioTempoFilter::init(int sampleRate, int channels, AVSampleFormat sampleFormat, double tempo) {
+	close();
+	if (sampleRate <= 0 || channels <= 0 || av_sample_fmt_is_planar(sampleFormat)) {
+		cerr << "AudioTempoFilter: Unsupported input format." << endl;
+		return false;
+	}
+
+	m_graph = avfilter_graph_alloc();
+	m_frame = av_frame_alloc();
+	if (!m_graph || !m_frame) {
+		cerr << "AudioTempoFilter: Could not allocate filter graph." << endl;
+		close();
+		return false;
+	}
+
+	AVChannelLayout layout;
+	av_channel_layout_default(&layout, channels);
+	char layout_name[64] = { 0 };
+	av_channel_layout_describe(&layout, layout_name, sizeof(layout_name));
+	av_channel_layout_uninit(&layout);
+	const char* fmt_name = av_get_sample_fmt_name(sampleFormat);
+
+	char src_args[256];
+	snprintf(src_args, sizeof(src_args), "time_base=1/%d:sample_rate=%d:sample_fmt=%s:channel_layout=%s",
+		sampleRate, sampleRate, fmt_name, layout_name);
+	char tempo_args[32];
+	snprintf(tempo_args, sizeof(tempo_args), "tempo=%.4f", tempo);
+	// atempo ʽһͬ aformat ̶Ϊʽ
+	char format_args[256];
+	snprintf(format_args, sizeof(format_args), "sample_fmts=%s:sample_rates=%d:channel_layouts=%s",
+		fmt_name, sampleRate, layout_name);
+
+	AVFilterContext* tempo_ctx = nullptr;
+	AVFilterContext* format_ctx = nullptr;
+	int ret = avfilter_graph_create_filter(&m_src, avfilter_get_by_name("abuffer"), "in", src_args, nullptr, m_graph);
+	if (ret >= 0) {
+		ret = avfilter_graph_create_filter(&tempo_ctx, avfilter_get_by_name("atempo"), "atempo", tempo_args, nullptr, m_graph);
+	}
+	if (ret >= 0) {
+		ret = avfilter_graph_create_filter(&format_ctx, avfilter_get_by_name("aformat"), "format", format_args, nullptr, m_graph);
+	}
+	if (ret >= 0) {
+		ret = avfilter_graph_create_filter(&m_sink, avfilter_get_by_name("abuffersink"), "out", nullptr, nullptr, m_graph);
+	}
+	if (ret >= 0) ret = avfilter_link(m_src, 0, tempo_ctx, 0);
+	if (ret >= 0) ret = avfilter_link(tempo_ctx, 0, format_ctx, 0);
+	if (ret >= 0) ret = avfilter_link(format_ctx, 0, m_sink, 0);
+	if (ret >= 0) ret = avfilter_graph_config(m_graph, nullptr);
+	if (ret < 0) {
+		char errbuf[AV_ERROR_MAX_STRING_SIZE];
+		av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, ret);
+		cerr << "AudioTempoFilter: Failed to build atempo graph: " << errbuf << endl;
+		close();
+		return false;
+	}
+
+	m_sample_rate = sampleRate;
+	m_channels = channels;
+	m_sample_fmt = sampleFormat;
+	m_tempo = tempo;
+	m_next_pts = 0;
+	cout << "AudioTempoFilter: Initialized (" << sampleRate << " Hz, " << layout_name << ", " << fmt_name
+		<< ", tempo " << tempo << ")." << endl;
+	return true;
+}
+
+bool AudioTempoFilter::setTempo(double tempo) {
+	if (!m_graph) {
+		return false;
+	}
+	char arg[32];
+	snprintf(arg, sizeof(arg), "%.4f", tempo);
+	int ret = avfilter_graph_send_command(m_graph, "atempo", "tempo", arg, nullptr, 0, 0);
+	if (ret < 0) {
+		cerr << "AudioTempoFilter: Failed to set tempo " << tempo << "." << endl;
+		return false;
+	}
+	m_tempo = tempo;
+	return true;
+}
+
+bool AudioTempoFilter::process(const uint8_t* data, int nbSamples, std::vector<uint8_t>& out) {
+	if (!m_graph || !data || nbSamples <= 0) {
+		return false;
+	}
+
+	const int bytes_per_sample_frame = av_get_bytes_per_sample(m_sample_fmt) * m_channels;
+
+	// 1. 
+	av_frame_unref(m_frame);
+	m_frame->format = m_sample_fmt;
+	m_frame->sample_rate = m_sample_rate;
+	m_frame->nb_samples = nbSamples;
+	av_channel_layout_default(&m_frame->ch_layout, m_channels);
+	m_frame->pts = m_next_pts;
+	if (av_frame_get_buffer(m_frame, 0) < 0) {
+		cerr << "AudioTempoFilter: Could not allocate input frame buffer." << endl;
+		return false;
+	}
+	memcpy(m_frame->data[0], data, static_cast<size_t>(nbSamples) * bytes_per_sample_frame);
+	m_next_pts += nbSamples;
+
+	int ret = av_buffersrc_add_frame(m_src, m_frame); // ɹ m_frame 
+	if (ret < 0) {
+		av_frame_unref(m_frame);
+		cerr << "AudioTempoFilter: av_buffersrc_add_frame() failed." << endl;
+		return false;
+	}
+
+	// 2. ȡǰõȫ
+	while ((ret = av_buffersink_get_frame(m_sink, m_frame)) >= 0) {
+		size_t bytes = static_cast<size_t>(m_frame->nb_samples) * bytes_per_sample_frame;
+		size_t offset = out.size();
+		out.resize(offset + bytes);
+		memcpy(out.data() + offset, m_frame->data[0], bytes);
+		av_frame_unref(m_frame);
+	}
+	return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF;
+}
+
+void AudioTempoFilter::close() {
+	if (m_graph) {
+		avfilter_graph_free(&m_graph); // ͬʱͷͼе˾
+	}
+	m_src = nullptr;
+	m_sink = nullptr;
+	if (m_frame) {
+		av_frame_free(&m_frame);
+	}
+	m_tempo = 1.0;
+}
@@ -56,6 +56,8 @@ void ClockManager::reset() {
     m_paused = true;
     m_start_time = SDL_GetTicks64(); // ȡSDLʼĺ
     m_paused_at = m_start_time; // ͣʱ뵽ǰ
+    m_external_base = 0.0;
+    m_playback_rate = 1.0;
 
     // Ĭϻ˵Ƶʱ (Ƶ)
     m_master_clock_type = MasterClockType::AUDIO;
@@ -77,8 +79,8 @@ double ClockManager::getExternalClockTime_nolock() {
     else {
         now = SDL_GetTicks64();
     }
-    // ⲿʱ = ǰͣʱ - ʱ
-    return (double)(now - m_start_time) / 1000.0;
+    // ⲿʱ = ׼ + (ǰͣʱ - ʱ) * 
+    return m_external_base + (double)(now - m_start_time) / 1000.0 * m_playback_rate;
 }
 
 void ClockManager::setMasterClock(MasterClockType type) {
@@ -152,8 +154,8 @@ double ClockManager::getAudioClockTime_nolock() {
     // ע⣺SDL_GetQueuedAudioSize ̰߳ȫģ lock µҲû
     Uint32 buffered_bytes = SDL_GetQueuedAudioSize(m_audio_device_id);
 
-    // 㻺ӳʱ
-    double buffered_duration_sec = (double)buffered_bytes / (double)m_audio_bytes_per_second;
+    // 㻺ӳʱ (ٲʱ豸еÿݶӦ rate ýʱ)
+    double buffered_duration_sec = (double)buffered_bytes / (double)m_audio_bytes_per_second * m_playback_rate;
 
     // ǰڲŵʱ = ĩβʱ - 
     // ʽ \[ T_{play} = PTS_{last\_written} - \frac{Bytes_{buffered}}{Bytes_{per\_second}} \]
@@ -246,5 +248,22 @@ void ClockManager::syncToPts(double pts) {
     // 3. У׼ⲿʱӵĻ׼ʱ
     // ȷ۵ǰʱ Audio  External׼Ѿ
     Uint64 now = m_paused ? m_paused_at : SDL_GetTicks64();
-    m_start_time = now - static_cast<Uint64>(pts * 1000.0);
+    m_start_time = now;
+    m_external_base = pts;
+}
+
+void ClockManager::setPlaybackRate(double rate) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (rate <= 0.0 || rate == m_playback_rate) {
+        return;
+    }
+    // ԵǰⲿʱΪ»׼֮ʱ֤ʱ
+    m_external_base = getExternalClockTime_nolock();
+    m_start_time = m_paused ? m_paused_at : SDL_GetTicks64();
+    m_playback_rate = rate;
+}
+
+double ClockManager::getPlaybackRate() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_playback_rate;
 }
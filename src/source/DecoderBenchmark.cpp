@@ -0,0 +1,206 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/DecoderBenchmark.h"
+#include "../include/FFmpegDemuxer.h"
+#include "../include/FFmpegVideoDecoder.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/time.h>
+}
+
+using namespace std;
+
+namespace {
+	// Ԥڴޣֹļ˹ʱ
+	constexpr size_t MAX_LOADED_BYTES = 512 * 1024 * 1024;
+}
+
+DecoderBenchmark::DecoderBenchmark(const std::string& path, double max_seconds)
+	: m_path(path), m_max_seconds(max_seconds) {}
+
+DecoderBenchmark::~DecoderBenchmark() {
+	for (AVPacket*& packet : m_packets) {
+		av_packet_free(&packet);
+	}
+	avcodec_parameters_free(&m_codecpar);
+}
+
+bool DecoderBenchmark::load() {
+	FFmpegDemuxer demuxer;
+	demuxer.setMemoryMappedInput(true);
+	if (!demuxer.open(m_path.c_str())) {
+		cerr << "DecoderBenchmark: Could not open " << m_path << "." << endl;
+		return false;
+	}
+	int stream_index = demuxer.findStream(AVMEDIA_TYPE_VIDEO);
+	if (stream_index < 0) {
+		cerr << "DecoderBenchmark: No video stream in " << m_path << "." << endl;
+		return false;
+	}
+	// ֻƵ
+	demuxer.selectStream(AVMEDIA_TYPE_AUDIO, -1);
+
+	m_codecpar = avcodec_parameters_alloc();
+	if (!m_codecpar || avcodec_parameters_copy(m_codecpar, demuxer.getCodecParameters(stream_index)) < 0) {
+		cerr << "DecoderBenchmark: Could not copy codec parameters." << endl;
+		return false;
+	}
+	m_time_base = demuxer.getTimeBase(stream_index);
+
+	// Ԥȶڴ棬ʹýͬһҲܴ IO Ӱ
+	size_t loaded_bytes = 0;
+	int64_t first_ts = AV_NOPTS_VALUE;
+	AVPacket* packet = av_packet_alloc();
+	while (packet && demuxer.readPacket(packet) >= 0) {
+		if (packet->stream_index != stream_index) {
+			av_packet_unref(packet);
+			continue;
+		}
+		int64_t ts = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+		if (ts != AV_NOPTS_VALUE) {
+			if (first_ts == AV_NOPTS_VALUE) {
+				first_ts = ts;
+			}
+			else if ((ts - first_ts) * av_q2d(m_time_base) >= m_max_seconds) {
+				av_packet_unref(packet);
+				break;
+			}
+		}
+		loaded_bytes += static_cast<size_t>(packet->size);
+		m_packets.push_back(packet);
+		packet = av_packet_alloc();
+		if (loaded_bytes >= MAX_LOADED_BYTES) {
+			break;
+		}
+	}
+	av_packet_free(&packet);
+
+	if (m_packets.empty()) {
+		cerr << "DecoderBenchmark: No video packets read from " << m_path << "." << endl;
+		return false;
+	}
+	cout << "DecoderBenchmark: Loaded " << m_packets.size() << " packets (" << (loaded_bytes >> 10) << " KB) of "
+		<< avcodec_get_name(m_codecpar->codec_id) << " " << m_codecpar->width << "x" << m_codecpar->height << "." << endl;
+	return true;
+}
+
+DecoderBenchmarkResult DecoderBenchmark::run(const DecoderBenchmarkCase& test_case) {
+	DecoderBenchmarkResult result;
+	result.label = test_case.label;
+
+	FFmpegVideoDecoder decoder;
+	decoder.setLowDelay(test_case.low_delay);
+	decoder.setThreading(test_case.threading);
+	if (!m_codecpar || !decoder.init(m_codecpar, m_time_base)) {
+		return result;
+	}
+	result.type = decoder.getThreadType();
+	result.threads = decoder.getThreadCount();
+
+	//  opaque ¼ţƵӦ֡ (AV_CODEC_FLAG_COPY_OPAQUE)ɴ˵õÿ֡ӳ
+	vector<int64_t> sent_at(m_packets.size(), 0);
+	vector<double> latencies;
+	latencies.reserve(m_packets.size());
+	size_t sent = 0;
+	int64_t start = av_gettime_relative();
+
+	AVFrame* frame = nullptr;
+	auto on_frame = [&](AVFrame* decoded) {
+		int64_t now = av_gettime_relative();
+		if (result.frames == 0) {
+			result.first_frame_ms = (now - start) / 1000.0;
+		}
+		result.frames++;
+		uintptr_t seq = reinterpret_cast<uintptr_t>(decoded->opaque);
+		if (seq > 0 && seq <= sent) {
+			latencies.push_back((now - sent_at[seq - 1]) / 1000.0);
+		}
+		result.max_pending = std::max(result.max_pending, static_cast<int>(sent - std::min<uint64_t>(sent, result.frames)));
+		return true;
+	};
+
+	int ret = 0;
+	for (size_t i = 0; i < m_packets.size() && ret >= 0; ++i) {
+		AVPacket* packet = m_packets[i];
+		packet->opaque = reinterpret_cast<void*>(static_cast<uintptr_t>(i + 1));
+		sent_at[i] = av_gettime_relative();
+		sent = i + 1;
+		ret = decoder.decodeAll(packet, &frame, on_frame);
+	}
+	if (ret >= 0) {
+		ret = decoder.decodeAll(nullptr, &frame, on_frame);
+	}
+	result.wall_sec = (av_gettime_relative() - start) / 1000000.0;
+	av_frame_free(&frame);
+
+	result.ok = (ret >= 0 || ret == AVERROR_EOF);
+	result.fps = result.wall_sec > 0.0 ? result.frames / result.wall_sec : 0.0;
+	if (!latencies.empty()) {
+		double total = 0.0;
+		for (double latency : latencies) {
+			total += latency;
+		}
+		result.avg_latency_ms = total / latencies.size();
+		std::sort(latencies.begin(), latencies.end());
+		result.p95_latency_ms = latencies[std::min(latencies.size() - 1, latencies.size() * 95 / 100)];
+		result.max_latency_ms = latencies.back();
+	}
+	return result;
+}
+
+std::vector<DecoderBenchmarkCase> DecoderBenchmark::defaultCases() {
+	std::vector<DecoderBenchmarkCase> cases;
+	cases.push_back({ "none", { DecoderThreadType::NONE, 1 }, false });
+	for (DecoderThreadType type : { DecoderThreadType::SLICE, DecoderThreadType::FRAME }) {
+		for (int threads : { 2, 4, 8, 0 }) {
+			std::string label = std::string(DecoderThreadBudget::typeName(type)) + " x" +
+				(threads > 0 ? std::to_string(threads) : std::string("auto"));
+			cases.push_back({ label, { type, threads }, false });
+		}
+	}
+	// ʵĬֵ㲥߳ñѡ񣬵ӳֱΪƬ߳
+	cases.push_back({ "player default", {}, false });
+	cases.push_back({ "low-latency live", {}, true });
+	return cases;
+}
+
+void DecoderBenchmark::printReport(const std::vector<DecoderBenchmarkResult>& results, std::ostream& out) const {
+	out << "\nDecoder benchmark: " << m_path << " (" << m_packets.size() << " packets, "
+		<< (m_codecpar ? avcodec_get_name(m_codecpar->codec_id) : "?") << ")\n";
+	out << std::left << std::setw(20) << "config" << std::setw(12) << "threading" << std::right
+		<< std::setw(10) << "fps" << std::setw(12) << "first ms" << std::setw(10) << "avg ms"
+		<< std::setw(10) << "p95 ms" << std::setw(10) << "max ms" << std::setw(9) << "pending" << "\n";
+	for (const DecoderBenchmarkResult& r : results) {
+		out << std::left << std::setw(20) << r.label;
+		if (!r.ok) {
+			out << "failed\n";
+			continue;
+		}
+		std::string threading = std::string(DecoderThreadBudget::typeName(r.type)) + " x" + std::to_string(r.threads);
+		out << std::setw(12) << threading << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(10) << r.fps << std::setw(12) << r.first_frame_ms << std::setw(10) << r.avg_latency_ms
+			<< std::setw(10) << r.p95_latency_ms << std::setw(10) << r.max_latency_ms << std::setw(9) << r.max_pending << "\n";
+	}
+	out << std::flush;
+}
@@ -0,0 +1,80 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/DecoderDrain.h"
+#include <iostream>
+
+using namespace std;
+
+int decodeAllFrames(AVCodecContext* ctx, AVPacket* packet, AVFrame** frame,
+	const std::function<bool(AVFrame* frame)>& onFrame, const char* tag) {
+	if (!frame || !onFrame) {
+		cerr << tag << " Error: Output frame pointer or callback is null." << endl;
+		return AVERROR(EINVAL);
+	}
+	if (!*frame) {
+		*frame = av_frame_alloc();
+		if (!*frame) {
+			cerr << tag << " Error: Failed to allocate AVFrame." << endl;
+			return AVERROR(ENOMEM);
+		}
+	}
+
+	bool sent = false;
+	while (true) {
+		if (!sent) {
+			int ret = avcodec_send_packet(ctx, packet);
+			// ϴʱѴڳϴ״̬ٴη nullptr  AVERROR_EOFֱӼȡ֡
+			if (ret == 0 || (ret == AVERROR_EOF && !packet)) {
+				sent = true;
+			}
+			else if (ret != AVERROR(EAGAIN)) {
+				char errbuf[AV_ERROR_MAX_STRING_SIZE];
+				av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, ret);
+				cerr << tag << " Error: Failed to send packet to decoder: " << errbuf << endl;
+				return ret;
+			}
+			// AVERROR(EAGAIN)ȡ֡һ·ͬһ
+		}
+
+		av_frame_unref(*frame);
+		int ret = avcodec_receive_frame(ctx, *frame);
+		if (ret == 0) {
+			if (!onFrame(*frame)) {
+				return AVERROR_EXIT;
+			}
+			continue;
+		}
+		if (ret == AVERROR(EAGAIN)) {
+			if (sent) {
+				return 0; // 룬ȡ
+			}
+			// ȴûȡAPI Լ֣ѭ
+			cerr << tag << " Error: Decoder accepts neither input nor output." << endl;
+			return AVERROR_BUG;
+		}
+		if (ret != AVERROR_EOF) {
+			char errbuf[AV_ERROR_MAX_STRING_SIZE];
+			av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, ret);
+			cerr << tag << " Error: Failed to receive frame from decoder: " << errbuf << endl;
+		}
+		return ret;
+	}
+}
@@ -0,0 +1,137 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/DecoderThreadBudget.h"
+#include <iostream>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// δܻȡ CPU ʱԤ㣬 FFmpeg Զѡ߳һ
+	constexpr int FALLBACK_THREAD_LIMIT = 16;
+
+	int hardwareThreads() {
+		unsigned int cores = std::thread::hardware_concurrency();
+		return cores > 0 ? static_cast<int>(cores) : FALLBACK_THREAD_LIMIT;
+	}
+}
+
+DecoderThreadBudget::DecoderThreadBudget() : m_limit(hardwareThreads()) {}
+
+DecoderThreadBudget& DecoderThreadBudget::instance() {
+	static DecoderThreadBudget budget;
+	return budget;
+}
+
+void DecoderThreadBudget::setLimit(int threads) {
+	lock_guard<mutex> lock(m_mutex);
+	m_limit = threads > 0 ? threads : hardwareThreads();
+}
+
+int DecoderThreadBudget::getLimit() const {
+	lock_guard<mutex> lock(m_mutex);
+	return m_limit;
+}
+
+int DecoderThreadBudget::getInUse() const {
+	lock_guard<mutex> lock(m_mutex);
+	return m_in_use;
+}
+
+int DecoderThreadBudget::acquire(int wanted) {
+	lock_guard<mutex> lock(m_mutex);
+	// ֻ߳̽ռõԼ̣߳ԤľʱȻԷֵ
+	int granted = std::max(1, std::min(wanted, m_limit - m_in_use));
+	m_in_use += granted;
+	return granted;
+}
+
+void DecoderThreadBudget::release(int threads) {
+	lock_guard<mutex> lock(m_mutex);
+	m_in_use = std::max(0, m_in_use - threads);
+}
+
+DecoderThreadConfig DecoderThreadBudget::resolve(const DecoderThreadConfig& requested, AVCodecID codec_id,
+	int width, int height, bool low_delay) {
+	DecoderThreadConfig config = requested;
+
+	if (config.type == DecoderThreadType::AUTO) {
+		if (low_delay) {
+			// ֡߳ÿ̶߳໺һ֡ӳֻʹƬ߳
+			config.type = DecoderThreadType::SLICE;
+		}
+		else {
+			switch (codec_id) {
+			// ̵֡߳ʵֳ졢ٱȸߵı
+			case AV_CODEC_ID_H264:
+			case AV_CODEC_ID_HEVC:
+			case AV_CODEC_ID_VP8:
+			case AV_CODEC_ID_VP9:
+			case AV_CODEC_ID_MPEG4:
+			case AV_CODEC_ID_PRORES:
+			case AV_CODEC_ID_FFV1:
+				config.type = DecoderThreadType::FRAME;
+				break;
+			// ֻ֧Ƭ߳
+			case AV_CODEC_ID_MPEG1VIDEO:
+			case AV_CODEC_ID_MPEG2VIDEO:
+			case AV_CODEC_ID_DVVIDEO:
+				config.type = DecoderThreadType::SLICE;
+				break;
+			//  (Դ̳߳ص AV1 )  FFmpeg ѡ
+			default:
+				break;
+			}
+		}
+	}
+
+	if (config.thread_count <= 0 && config.type != DecoderThreadType::NONE) {
+		// ֱ߳ӣ̵֡߳߳ԽӳԽСֱò
+		long long pixels = static_cast<long long>(width) * height;
+		if (pixels <= 0 || pixels > 1920LL * 1088) {
+			config.thread_count = 12;
+		}
+		else if (pixels > 1280LL * 720) {
+			config.thread_count = 8;
+		}
+		else if (pixels > 640LL * 480) {
+			config.thread_count = 4;
+		}
+		else {
+			config.thread_count = 2;
+		}
+		config.thread_count = std::min(config.thread_count, hardwareThreads());
+	}
+	if (config.type == DecoderThreadType::NONE) {
+		config.thread_count = 1;
+	}
+	return config;
+}
+
+const char* DecoderThreadBudget::typeName(DecoderThreadType type) {
+	switch (type) {
+	case DecoderThreadType::NONE:	return "none";
+	case DecoderThreadType::FRAME:	return "frame";
+	case DecoderThreadType::SLICE:	return "slice";
+	default:						return "auto";
+	}
+}
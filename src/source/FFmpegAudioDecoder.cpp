@@ -19,6 +19,7 @@
  */
 
 #include "../include/FFmpegAudioDecoder.h"
+#include "../include/DecoderDrain.h"
 #include <stdexcept>
 
 using namespace std;
@@ -127,6 +128,14 @@ int FFmpegAudioDecoder::decode(AVPacket* packet, AVFrame** frame) {
     return ret;
 }
 
+int FFmpegAudioDecoder::decodeAll(AVPacket* packet, AVFrame** frame, const FrameCallback& onFrame) {
+    if (!m_codecContext) {
+        cerr << "FFmpegAudioDecoder::decodeAll Error: Decoder not initialized or has been closed." << endl;
+        return AVERROR(EINVAL);
+    }
+    return decodeAllFrames(m_codecContext, packet, frame, onFrame, "FFmpegAudioDecoder::decodeAll");
+}
+
 void FFmpegAudioDecoder::flush() {
     if (m_codecContext) {
         avcodec_flush_buffers(m_codecContext);
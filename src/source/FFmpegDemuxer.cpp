@@ -20,6 +20,8 @@
 
 #include "../include/FFmpegDemuxer.h"
 #include <iostream>
+#include <cstring>	// strlen, memcmp
+#include <algorithm>	// std::min
 
 using namespace std;
 
@@ -35,6 +37,13 @@ int FFmpegDemuxer::interruptCallback(void* opaque) {
 		std::cout << "FFmpegDemuxer: Interrupt requested." << std::endl;
 		return 1;
 	}
+	// ǰʱ (/)ͬж
+	if (demuxer) {
+		int64_t deadline = demuxer->m_deadline_us.load();
+		if (deadline > 0 && av_gettime_relative() > deadline) {
+			return 1;
+		}
+	}
 	// 򷵻 0ִ
 	return 0;
 }
@@ -42,6 +51,61 @@ int FFmpegDemuxer::interruptCallback(void* opaque) {
 // жϵĹ
 void FFmpegDemuxer::requestAbort(bool abort) {
 	m_abort_request.store(abort);
+	if (m_readAhead) {
+		m_readAhead->requestAbort(abort);
+	}
+}
+
+void FFmpegDemuxer::setReadAhead(size_t bytes) {
+	m_readAheadBytes = bytes;
+}
+
+void FFmpegDemuxer::setMemoryMappedInput(bool enable) {
+	m_useMemoryMap = enable;
+}
+
+void FFmpegDemuxer::setKeyframeIndexCache(bool enable) {
+	m_useKeyframeIndex = enable;
+}
+
+void FFmpegDemuxer::setLowLatency(bool enable) {
+	m_lowLatency = enable;
+}
+
+void FFmpegDemuxer::setTimeouts(int open_timeout_ms, int read_timeout_ms) {
+	m_openTimeoutUs = static_cast<int64_t>(open_timeout_ms) * 1000;
+	m_readTimeoutUs = static_cast<int64_t>(read_timeout_ms) * 1000;
+}
+
+ReconnectStats FFmpegDemuxer::getReconnectStats() const {
+	std::lock_guard<std::mutex> lock(m_reconnectMutex);
+	return m_reconnectStats;
+}
+
+void FFmpegDemuxer::beginOperation(int64_t timeout_us) {
+	m_deadline_us.store(timeout_us > 0 ? av_gettime_relative() + timeout_us : 0);
+}
+
+void FFmpegDemuxer::endOperation() {
+	m_deadline_us.store(0);
+}
+
+bool FFmpegDemuxer::isRealtimeUrl(const std::string& url) {
+	static const char* const prefixes[] = { "rtsp://", "rtsps://", "rtmp://", "rtmps://", "udp://", "rtp://", "srt://" };
+	for (const char* prefix : prefixes) {
+		if (url.compare(0, strlen(prefix), prefix) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FFmpegDemuxer::getReadAheadStats(ReadAheadStats& stats) const {
+	if (!m_readAhead) {
+		return false;
+	}
+	stats = m_readAhead->getStats();
+	return true;
 }
 
 bool FFmpegDemuxer::open(const char* url) {
@@ -52,26 +116,85 @@ bool FFmpegDemuxer::open(const char* url) {
 	m_isLiveStream = false; // ĬΪ㲥ģʽ
 	m_abort_request.store(false); // жϱ־
 
-	pFormatCtx = avformat_alloc_context();
-	if (!pFormatCtx) {
+	if (!openInput(url)) {
+		return false;
+	}
+	m_url = url;
+
+	// --- ǷΪֱ ---
+	if (pFormatCtx) {
+		std::string formatName = pFormatCtx->iformat->name ? pFormatCtx->iformat->name : "";
+		std::string urlStr = url;
+
+		// Э/ʽǿƥ
+		if (formatName == "rtsp" || formatName == "flv" || formatName == "hls" || formatName == "rtp") {
+			// ע⣺flvhlsҲǵ㲥ͨΪֱ߼ȫ
+			// ȷļflvͨduration
+			m_isLiveStream = true;
+		}
+		// URL Эͷ
+		else if (isRealtimeUrl(urlStr)) {
+			m_isLiveStream = true;
+		}
+		// 飺ʱ  Seek
+		// ע⣺Щֱм޴ duration (INT64_MAX) 0
+		else if (pFormatCtx->duration == AV_NOPTS_VALUE) {
+			m_isLiveStream = true;
+		}
+		// IO Context 
+		else if (pFormatCtx->pb && !(pFormatCtx->pb->seekable & AVIO_SEEKABLE_NORMAL)) {
+			// ײIO֧seekͨΪֱ
+			m_isLiveStream = true;
+		}
+	}
+
+	initKeyframeIndex(url);
+
+	cout << "FFmpegDemuxer: Opened " << url << " successfully." << endl;
+	if (m_videoStreamIndex != -1) {
+		cout << " Video stream index: " << m_videoStreamIndex << endl;
+	}
+	if (m_audioStreamIndex != -1) {
+		cout << " Audio stream index: " << m_audioStreamIndex << endl;
+	}
+	cout << "FFmpegDemuxer: Stream is detected as: " << (m_isLiveStream ? "LIVE" : "VOD/LOCAL") << endl;
+
+	return true;
+}
+
+bool FFmpegDemuxer::openInput(const char* url) {
+	AVFormatContext* ctx = avformat_alloc_context();
+	if (!ctx) {
 		cerr << "FFmpegDemuxer Error: Could not allocate format context." << endl;
 		return false;
 	}
 
 	// жϻص
-	pFormatCtx->interrupt_callback.callback = FFmpegDemuxer::interruptCallback;
-	pFormatCtx->interrupt_callback.opaque = this; // ǰʵΪĴ
+	ctx->interrupt_callback.callback = FFmpegDemuxer::interruptCallback;
+	ctx->interrupt_callback.opaque = this; // ǰʵΪĴ
+
+	// Զ IO (ڴӳ̨Ԥ)
+	setupCustomIO(ctx, url);
 
 	// ѡ
 	AVDictionary* opts = nullptr;
 	// 1. RTSPЭΪTCPFFmpegĬϿܳUDPĳЩ¿ʧܡ
 	av_dict_set(&opts, "rtsp_transport", "tcp", 0);
-	// 2. óʱʱ䣨λ΢룩˴5볬ʱֹ翨ʱ
-	av_dict_set(&opts, "stimeout", "5000000", 0);
+	// 2. ʱͨЭص stimeout/timeout ѡ (stimeout ѷ)
+	//    жϻصֹʱͳһжϣ beginOperation()
 	av_dict_set(&opts, "buffer_size", "1024000", 0); // ӵײջ
+	// 3. ӳ٣װΪ̽Ѷİֻ̽ȡ
+	//    (˵ low_delay Ƶ)
+	if (m_lowLatency && isRealtimeUrl(url)) {
+		av_dict_set(&opts, "fflags", "nobuffer", 0);
+		av_dict_set(&opts, "probesize", "65536", 0);			// ֽ
+		av_dict_set(&opts, "analyzeduration", "200000", 0);	// ΢
+		cout << "FFmpegDemuxer: Opening with low-latency options." << endl;
+	}
 	
-	// ոõѡ
-	int ret = avformat_open_input(&pFormatCtx, url, nullptr, &opts);
+	// ոõѡ̽Ϣһʱ
+	beginOperation(m_openTimeoutUs);
+	int ret = avformat_open_input(&ctx, url, nullptr, &opts);
 	// Ƿδʹõѡڵԣͷֵ
 	if (opts) {
 		char* value = nullptr;
@@ -87,73 +210,144 @@ bool FFmpegDemuxer::open(const char* url) {
 		char errbuf[1024] = { 0 };
 		av_strerror(ret, errbuf, sizeof(errbuf));
 		cerr << "FFmpegDemuxer Error: Couldn't open input stream: " << url << " (" << errbuf << ")" << endl;
-		avformat_free_context(pFormatCtx);
-		pFormatCtx = nullptr;
+		endOperation();
+		// ʧʱ avformat_open_input ͷĲÿ
+		releaseCustomIO();
 		return false;
 	}
 
 	// Ϣ
-	if (avformat_find_stream_info(pFormatCtx, nullptr) < 0) {
+	ret = avformat_find_stream_info(ctx, nullptr);
+	endOperation();
+	if (ret < 0) {
 		cerr << "FFmpegDemuxer Error: Couldn't find stream information." << endl;
-		avformat_close_input(&pFormatCtx);
-		pFormatCtx = nullptr;
+		avformat_close_input(&ctx);
+		releaseCustomIO();
 		return false;
 	}
 
 	// йļϢת浽׼
-	av_dump_format(pFormatCtx, 0, url, 0);
+	av_dump_format(ctx, 0, url, 0);
 
-	m_url = url;
+	// ȫ򿪺ٷ̲߳ῴ̽е
+	{
+		std::lock_guard<std::mutex> lock(m_contextMutex);
+		pFormatCtx = ctx;
+	}
 	findStreamsInternal();
+	return true;
+}
 
-	// --- ǷΪֱ ---
+void FFmpegDemuxer::close() {
+	requestAbort(true); // ڹرǰжϣԷ߳̿ڶȡ
+	saveKeyframeIndex();
 	if (pFormatCtx) {
-		std::string formatName = pFormatCtx->iformat->name ? pFormatCtx->iformat->name : "";
-		std::string urlStr = url;
+		closeInput();
+		m_url.clear();
+		cout << "FFmpegDemuxer: Closed." << endl;
+	}
+	releaseCustomIO();
+}
 
-		// Э/ʽǿƥ
-		if (formatName == "rtsp" || formatName == "flv" || formatName == "hls" || formatName == "rtp") {
-			// ע⣺flvhlsҲǵ㲥ͨΪֱ߼ȫ
-			// ȷļflvͨduration
-			m_isLiveStream = true;
-		}
-		// URL Эͷ
-		else if (urlStr.find("rtsp://") == 0 || urlStr.find("rtmp://") == 0 || urlStr.find("udp://") == 0) {
-			m_isLiveStream = true;
-		}
-		// 飺ʱ  Seek
-		// ע⣺Щֱм޴ duration (INT64_MAX) 0
-		else if (pFormatCtx->duration == AV_NOPTS_VALUE) {
-			m_isLiveStream = true;
+void FFmpegDemuxer::closeInput() {
+	AVFormatContext* ctx = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_contextMutex);
+		ctx = pFormatCtx;
+		pFormatCtx = nullptr;
+	}
+	if (ctx) {
+		avformat_close_input(&ctx);
+	}
+	m_videoStreamIndex = -1;
+	m_audioStreamIndex = -1;
+	// Զ IO Ĳ avformat_close_input ͷţ֮ر
+	releaseCustomIO();
+}
+
+void FFmpegDemuxer::setupCustomIO(AVFormatContext* ctx, const char* url) {
+	// 1. ļڴӳ䣬ֱҳ
+	if (m_useMemoryMap && MappedFileIOContext::isLocalFile(url)) {
+		m_mappedFile = std::make_unique<MappedFileIOContext>();
+		if (m_mappedFile->open(url) == 0) {
+			ctx->pb = m_mappedFile->getAVIOContext();
+			return;
 		}
-		// IO Context 
-		else if (pFormatCtx->pb && !(pFormatCtx->pb->seekable & AVIO_SEEKABLE_NORMAL)) {
-			// ײIO֧seekͨΪֱ
-			m_isLiveStream = true;
+		cerr << "FFmpegDemuxer: Memory mapping unavailable, falling back." << endl;
+		m_mappedFile.reset();
+	}
+
+	// 2. Ԥ IOɺ̨߳ǰݣװֱ̲߳ڴ/ȡ
+	if (m_readAheadBytes > 0 && ReadAheadIOContext::isSupported(url)) {
+		m_readAhead = std::make_unique<ReadAheadIOContext>(m_readAheadBytes);
+		int io_ret = m_readAhead->open(url, &ctx->interrupt_callback);
+		if (io_ret == 0) {
+			ctx->pb = m_readAhead->getAVIOContext();
+			return;
 		}
+		// Ԥʱ˻ FFmpeg Ĭ IO
+		char errbuf[AV_ERROR_MAX_STRING_SIZE];
+		av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, io_ret);
+		cerr << "FFmpegDemuxer: Read-ahead unavailable (" << errbuf << "), using default IO." << endl;
+		m_readAhead.reset();
 	}
+}
 
-	cout << "FFmpegDemuxer: Opened " << url << " successfully." << endl;
-	if (m_videoStreamIndex != -1) {
-		cout << " Video stream index: " << m_videoStreamIndex << endl;
+void FFmpegDemuxer::releaseCustomIO() {
+	m_readAhead.reset();
+	m_mappedFile.reset();
+}
+
+void FFmpegDemuxer::initKeyframeIndex(const char* url) {
+	m_keyframeIndexActive = false;
+	if (!m_useKeyframeIndex || m_isLiveStream || !MappedFileIOContext::isLocalFile(url)) {
+		return;
 	}
-	if (m_audioStreamIndex != -1) {
-		cout << " Audio stream index: " << m_audioStreamIndex << endl;
+	// ֻڿ԰ֽ seekȱĸʽ
+	// MPEG-TS/PS (AVFMT_TS_DISCONT)  (ͨʱ)MP4/MKV Դԭ seek 㹻
+	const AVInputFormat* iformat = pFormatCtx->iformat;
+	bool needs_index = (iformat->flags & AVFMT_TS_DISCONT) ||
+		((iformat->flags & AVFMT_GENERIC_INDEX) && (iformat->flags & AVFMT_NOTIMESTAMPS));
+	if (!needs_index || (iformat->flags & AVFMT_NO_BYTE_SEEK)) {
+		return;
+	}
+	int stream_index = m_videoStreamIndex >= 0 ? m_videoStreamIndex : m_audioStreamIndex;
+	if (stream_index < 0) {
+		return;
 	}
-	cout << "FFmpegDemuxer: Stream is detected as: " << (m_isLiveStream ? "LIVE" : "VOD/LOCAL") << endl;
 
-	return true;
+	std::string path = url;
+	if (path.compare(0, 5, "file:") == 0) {
+		path.erase(0, 5);
+	}
+	int64_t file_size = 0, file_mtime = 0;
+	if (!KeyframeIndex::statFile(path, file_size, file_mtime)) {
+		return;
+	}
+	m_keyframeIndex.reset(stream_index, pFormatCtx->streams[stream_index]->time_base, file_size, file_mtime);
+	m_keyframeIndexPath = path + ".kfidx";
+	m_keyframeIndexActive = true;
+
+	if (m_keyframeIndex.load(m_keyframeIndexPath)) {
+		cout << "FFmpegDemuxer: Loaded keyframe index with " << m_keyframeIndex.size() << " entries." << endl;
+	}
 }
 
-void FFmpegDemuxer::close() {
-	requestAbort(true); // ڹرǰжϣԷ߳̿ڶȡ
-	if (pFormatCtx) {
-		avformat_close_input(&pFormatCtx);
-		pFormatCtx = nullptr;
-		m_videoStreamIndex = -1;
-		m_audioStreamIndex = -1;
-		m_url.clear();
-		cout << "FFmpegDemuxer: Closed." << endl;
+void FFmpegDemuxer::saveKeyframeIndex() {
+	if (!m_keyframeIndexActive) {
+		return;
+	}
+	m_keyframeIndexActive = false;
+	if (!m_keyframeIndex.isDirty() || m_keyframeIndex.size() == 0) {
+		return;
+	}
+	if (m_keyframeIndex.save(m_keyframeIndexPath)) {
+		cout << "FFmpegDemuxer: Saved keyframe index with " << m_keyframeIndex.size() << " entries to "
+			<< m_keyframeIndexPath << "." << endl;
+	}
+	else {
+		// ýĿ¼ֻ½棬Ӱ첥
+		cerr << "FFmpegDemuxer: Could not write keyframe index to " << m_keyframeIndexPath << "." << endl;
 	}
 }
 
@@ -161,7 +355,27 @@ int FFmpegDemuxer::readPacket(AVPacket* packet) {
 	if (!pFormatCtx) {
 		return AVERROR(EINVAL); // Ч״̬ûд
 	}
-	return av_read_frame(pFormatCtx, packet); // ȡһ frame/packet
+	// ʵʱÿζʱޣ羲Ĭʱ޼شɵ÷ж
+	bool timed = m_isLiveStream && m_readTimeoutUs > 0;
+	if (timed) {
+		beginOperation(m_readTimeoutUs);
+	}
+	int ret = av_read_frame(pFormatCtx, packet); // ȡһ frame/packet
+	if (timed) {
+		endOperation();
+		if (ret == AVERROR_EXIT && !m_abort_request.load()) {
+			ret = AVERROR(ETIMEDOUT);
+		}
+	}
+	if (m_keyframeIndexActive) {
+		if (ret == 0) {
+			m_keyframeIndex.addPacket(packet);
+		}
+		else if (ret == AVERROR_EOF) {
+			m_keyframeIndex.onEndOfFile();
+		}
+	}
+	return ret;
 }
 
 int FFmpegDemuxer::seek(double timestamp_sec) {
@@ -171,6 +385,23 @@ int FFmpegDemuxer::seek(double timestamp_sec) {
 	// -1 ʾʹĬͨƵ
 	int64_t seek_target_ts = static_cast<int64_t>(timestamp_sec * AV_TIME_BASE);
 
+	// ʹùؼֱ֡ӰֽλĿ֮ǰĹؼ֡
+	if (m_keyframeIndexActive) {
+		m_keyframeIndex.onDiscontinuity();
+		AVRational time_base_q = { 1, AV_TIME_BASE };
+		AVRational stream_time_base = pFormatCtx->streams[m_keyframeIndex.streamIndex()]->time_base;
+		int64_t target_pts = av_rescale_q(seek_target_ts, time_base_q, stream_time_base);
+		KeyframeIndex::Entry entry;
+		if (m_keyframeIndex.lookup(target_pts, entry)) {
+			int ret = av_seek_frame(pFormatCtx, -1, entry.pos, AVSEEK_FLAG_BYTE);
+			if (ret >= 0) {
+				std::cout << "FFmpegDemuxer: Seek to " << timestamp_sec << "s via keyframe index (keyframe at "
+					<< entry.pts * av_q2d(stream_time_base) << "s, byte " << entry.pos << ")." << std::endl;
+				return ret;
+			}
+		}
+	}
+
 	// AVSEEK_FLAG_BACKWARD: seekseek0ͷǱҪ
 	int ret = av_seek_frame(pFormatCtx, -1, seek_target_ts, AVSEEK_FLAG_BACKWARD);
 
@@ -195,6 +426,58 @@ void FFmpegDemuxer::findStreamsInternal() {
 
 	m_videoStreamIndex = av_find_best_stream(pFormatCtx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
 	m_audioStreamIndex = av_find_best_stream(pFormatCtx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+	applyStreamDiscard();
+}
+
+void FFmpegDemuxer::applyStreamDiscard() {
+	if (!pFormatCtx) return;
+
+	// 졢Ļ ( SCTE-35/KLV) av_read_frame ڲ
+	//  PES 顢ʹʡȥٶĿ
+	int discarded = 0;
+	for (unsigned int i = 0; i < pFormatCtx->nb_streams; ++i) {
+		AVStream* stream = pFormatCtx->streams[i];
+		bool selected = static_cast<int>(i) == m_videoStreamIndex || static_cast<int>(i) == m_audioStreamIndex;
+		stream->discard = selected ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+		if (!selected) {
+			discarded++;
+		}
+	}
+	if (discarded > 0) {
+		cout << "FFmpegDemuxer: Discarding " << discarded << " of " << pFormatCtx->nb_streams << " streams." << endl;
+	}
+}
+
+std::vector<int> FFmpegDemuxer::getStreamIndices(AVMediaType type) const {
+	std::vector<int> indices;
+	if (!pFormatCtx) return indices;
+
+	for (unsigned int i = 0; i < pFormatCtx->nb_streams; ++i) {
+		const AVStream* stream = pFormatCtx->streams[i];
+		// ͼȸͼƬǿɲŵƵ
+		if (stream->codecpar->codec_type == type && !(stream->disposition & AV_DISPOSITION_ATTACHED_PIC)) {
+			indices.push_back(static_cast<int>(i));
+		}
+	}
+	return indices;
+}
+
+bool FFmpegDemuxer::selectStream(AVMediaType type, int streamIndex) {
+	if (!pFormatCtx || (type != AVMEDIA_TYPE_VIDEO && type != AVMEDIA_TYPE_AUDIO)) {
+		return false;
+	}
+	if (streamIndex >= static_cast<int>(pFormatCtx->nb_streams) ||
+		(streamIndex >= 0 && pFormatCtx->streams[streamIndex]->codecpar->codec_type != type)) {
+		cerr << "FFmpegDemuxer: Stream " << streamIndex << " is not a valid "
+			<< av_get_media_type_string(type) << " stream." << endl;
+		return false;
+	}
+
+	int& selected = (type == AVMEDIA_TYPE_VIDEO) ? m_videoStreamIndex : m_audioStreamIndex;
+	selected = streamIndex < 0 ? -1 : streamIndex;
+	applyStreamDiscard();
+	cout << "FFmpegDemuxer: Selected " << av_get_media_type_string(type) << " stream " << selected << "." << endl;
+	return true;
 }
 
 int FFmpegDemuxer::findStream(AVMediaType type) const {
@@ -210,6 +493,8 @@ int FFmpegDemuxer::findStream(AVMediaType type) const {
 }
 
 AVCodecParameters* FFmpegDemuxer::getCodecParameters(int streamIndex)const {
+	// ߳Ҳãֻ֤ģ滻ģصָ´ǰЧ
+	std::lock_guard<std::mutex> lock(m_contextMutex);
 	if (!pFormatCtx || streamIndex < 0 || streamIndex >= static_cast<int>(pFormatCtx->nb_streams)) {
 		return nullptr; // Ч
 	}
@@ -242,7 +527,16 @@ double FFmpegDemuxer::getDuration() const {
 	}
 }
 
+double FFmpegDemuxer::getStartTime() const {
+	std::lock_guard<std::mutex> lock(m_contextMutex);
+	if (!pFormatCtx || pFormatCtx->start_time == AV_NOPTS_VALUE) {
+		return 0.0;
+	}
+	return static_cast<double>(pFormatCtx->start_time) / AV_TIME_BASE;
+}
+
 AVRational FFmpegDemuxer::getTimeBase(int streamIndex) const {
+	std::lock_guard<std::mutex> lock(m_contextMutex);
 	if (!pFormatCtx || streamIndex < 0 || streamIndex >= static_cast<int>(pFormatCtx->nb_streams)) {
 		// ЧԽ磬һЧʱ
 		return { 0, 1 };
@@ -255,10 +549,145 @@ bool FFmpegDemuxer::isLiveStream() const {
 	return m_isLiveStream; 
 }
 
+bool FFmpegDemuxer::sameCodecParameters(const AVCodecParameters* a, const AVCodecParameters* b) {
+	if (!a || !b) {
+		return a == b;
+	}
+	if (a->codec_type != b->codec_type || a->codec_id != b->codec_id) {
+		return false;
+	}
+	// ֱ/ظʽ/ͺתã
+	// extradata (SPS/PPSAudioSpecificConfig ) 仯ζűù
+	if (a->width != b->width || a->height != b->height || a->format != b->format ||
+		a->sample_rate != b->sample_rate || a->ch_layout.nb_channels != b->ch_layout.nb_channels) {
+		return false;
+	}
+	if (a->extradata_size != b->extradata_size) {
+		return false;
+	}
+	return a->extradata_size == 0 || memcmp(a->extradata, b->extradata, a->extradata_size) == 0;
+}
+
+IDemuxer::ReconnectResult FFmpegDemuxer::reconnect(int max_attempts) {
+	if (m_url.empty() || m_abort_request.load()) {
+		return ReconnectResult::FAILED;
+	}
+
+	// ¶ϿǰѡеݴжѴ򿪵Ľܷʹ
+	struct SelectedStream {
+		AVMediaType type;
+		int index;
+		AVRational time_base;
+		AVCodecParameters* params;
+	};
+	SelectedStream selected[2] = {
+		{ AVMEDIA_TYPE_VIDEO, m_videoStreamIndex, { 0, 1 }, nullptr },
+		{ AVMEDIA_TYPE_AUDIO, m_audioStreamIndex, { 0, 1 }, nullptr }
+	};
+	for (SelectedStream& s : selected) {
+		if (s.index >= 0 && pFormatCtx) {
+			const AVStream* stream = pFormatCtx->streams[s.index];
+			s.time_base = stream->time_base;
+			s.params = avcodec_parameters_alloc();
+			if (s.params) {
+				avcodec_parameters_copy(s.params, stream->codecpar);
+			}
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_reconnectMutex);
+		m_reconnectStats.outages++;
+		m_reconnectStats.reconnecting = true;
+	}
+	cout << "FFmpegDemuxer: Connection lost, reconnecting to " << m_url << "..." << endl;
+
+	const int64_t start_us = av_gettime_relative();
+	int delay_ms = RECONNECT_INITIAL_DELAY_MS;
+	bool connected = false;
+	int attempt = 0;
+	while (!m_abort_request.load() && (max_attempts <= 0 || attempt < max_attempts)) {
+		// һ (Ƿ/˲)ָ֮˱ܵȴȴڼɱж
+		if (attempt > 0) {
+			int64_t wake_us = av_gettime_relative() + static_cast<int64_t>(delay_ms) * 1000;
+			while (!m_abort_request.load() && av_gettime_relative() < wake_us) {
+				av_usleep(10000);
+			}
+			delay_ms = std::min(delay_ms * 2, RECONNECT_MAX_DELAY_MS);
+			if (m_abort_request.load()) {
+				break;
+			}
+		}
+		attempt++;
+		{
+			std::lock_guard<std::mutex> lock(m_reconnectMutex);
+			m_reconnectStats.attempts++;
+		}
+
+		closeInput();
+		if (openInput(m_url.c_str())) {
+			connected = true;
+			break;
+		}
+		cerr << "FFmpegDemuxer: Reconnect attempt " << attempt << " failed." << endl;
+	}
+
+	bool same = false;
+	if (connected) {
+		// ָϿǰѡ (л)ٱȽʱ
+		same = true;
+		for (SelectedStream& s : selected) {
+			int current = (s.type == AVMEDIA_TYPE_VIDEO) ? m_videoStreamIndex : m_audioStreamIndex;
+			if (current != s.index && !selectStream(s.type, s.index)) {
+				same = false;
+				continue;
+			}
+			if (s.index < 0) {
+				continue;
+			}
+			const AVStream* stream = pFormatCtx->streams[s.index];
+			if (av_cmp_q(stream->time_base, s.time_base) != 0 || !sameCodecParameters(stream->codecpar, s.params)) {
+				same = false;
+			}
+		}
+	}
+	for (SelectedStream& s : selected) {
+		avcodec_parameters_free(&s.params);
+	}
+
+	double elapsed_ms = (av_gettime_relative() - start_us) / 1000.0;
+	{
+		std::lock_guard<std::mutex> lock(m_reconnectMutex);
+		m_reconnectStats.reconnecting = false;
+		m_reconnectStats.total_outage_ms += elapsed_ms;
+		if (connected) {
+			m_reconnectStats.last_reconnect_ms = elapsed_ms;
+			if (same) {
+				m_reconnectStats.warm_restarts++;
+			}
+		}
+		else {
+			m_reconnectStats.failures++;
+		}
+	}
+
+	if (!connected) {
+		cerr << "FFmpegDemuxer: Giving up reconnecting after " << attempt << " attempts." << endl;
+		return ReconnectResult::FAILED;
+	}
+	cout << "FFmpegDemuxer: Reconnected in " << elapsed_ms << " ms after " << attempt << " attempts ("
+		<< (same ? "same streams" : "streams changed") << ")." << endl;
+	return same ? ReconnectResult::SAME_STREAMS : ReconnectResult::STREAMS_CHANGED;
+}
+
 void FFmpegDemuxer::flushIO() {
 	if (pFormatCtx && pFormatCtx->pb) {
 		// ǿˢ»
 		//  FFmpeg Ӧòά IO 
 		avio_flush(pFormatCtx->pb);
 	}
+	if (m_readAhead) {
+		// ͬʱԤδ
+		m_readAhead->discardBuffered();
+	}
 }
\ No newline at end of file
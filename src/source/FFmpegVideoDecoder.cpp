@@ -19,6 +19,7 @@
  */
 
 #include "../include/FFmpegVideoDecoder.h"
+#include "../include/DecoderDrain.h"
 #include <iostream>
 
 extern "C" {
@@ -72,17 +73,50 @@ bool FFmpegVideoDecoder::init(AVCodecParameters* codecParams, AVRational timeBas
 	// ֶʱ
 	m_codecContext->time_base = timeBase;
 
-	// ö߳̽
-	m_codecContext->thread_count = 0; // 0 ʾԶ CPU 
-	// m_codecContext->thread_type ĬϣFFmpeg Զѡ
+	// ߳̽룺߳ñȫ AUTO  (ӳʱΪƬ)߳ӽڵ߳Ԥ
+	if (m_lowDelay) {
+		m_codecContext->flags |= AV_CODEC_FLAG_LOW_DELAY;
+	}
+	DecoderThreadConfig threading = DecoderThreadBudget::resolve(m_threading, codecParams->codec_id,
+		codecParams->width, codecParams->height, m_lowDelay);
+	m_threadCount = DecoderThreadBudget::instance().acquire(threading.thread_count);
+	m_codecContext->thread_count = m_threadCount;
+	if (threading.type == DecoderThreadType::FRAME) {
+		m_codecContext->thread_type = FF_THREAD_FRAME;
+	}
+	else if (threading.type == DecoderThreadType::SLICE) {
+		m_codecContext->thread_type = FF_THREAD_SLICE;
+	}
+	//  m_codecContext->thread_type ĬϣFFmpeg Զѡ
+
+	// ݰ opaque ݵ֡ڲʵʱհʾӳ
+	m_codecContext->flags |= AV_CODEC_FLAG_COPY_OPAQUE;
 
 	// 4򿪽
 	if (avcodec_open2(m_codecContext, codec, nullptr) < 0) {
 		cerr << "FFmpegVideoDecoder::init Error: Could not open codec (" << codec->long_name << endl;
 		avcodec_free_context(&m_codecContext);
+		releaseThreads();
 		return false;
 	}
 
+	// ֧߳ģʱֻõ߳̽룬黹߳
+	if (m_codecContext->active_thread_type & FF_THREAD_FRAME) {
+		m_threadType = DecoderThreadType::FRAME;
+	}
+	else if (m_codecContext->active_thread_type & FF_THREAD_SLICE) {
+		m_threadType = DecoderThreadType::SLICE;
+	}
+	else {
+		m_threadType = DecoderThreadType::NONE;
+		if (m_threadCount > 1) {
+			DecoderThreadBudget::instance().release(m_threadCount - 1);
+			m_threadCount = 1;
+		}
+	}
+	cout << "FFmpegVideoDecoder: Threading " << DecoderThreadBudget::typeName(m_threadType) << " x" << m_threadCount
+		<< " (budget " << DecoderThreadBudget::instance().getInUse() << "/" << DecoderThreadBudget::instance().getLimit() << ")." << endl;
+
 	cout << "FFmpegVideoDecoder initialized successfully with codec: " << codec->long_name << ", TimeBase: " << timeBase.num << "/" << timeBase.den << endl;
 	return true;
 }
@@ -96,8 +130,6 @@ int FFmpegVideoDecoder::decode(AVPacket* packet, AVFrame** frame) {
 		cerr << "FFmpegVideoDecoder::decode Error: Output frame pointer (frame) is null." << endl;
 		return AVERROR(EINVAL);
 	}
-	*frame = nullptr; // ȷʼ0
-
 	//  1 ݰ
 	// packet Ϊ nullptr ʾϴEOFźţ
 	int ret = avcodec_send_packet(m_codecContext, packet);
@@ -116,22 +148,27 @@ int FFmpegVideoDecoder::decode(AVPacket* packet, AVFrame** frame) {
 	// ӿsendreceivereceive״̬
 
 	// 2ӽս֡
-	AVFrame* decoded_frame = av_frame_alloc();
-	if (!decoded_frame) {
-		cerr << "FFmpegVideoDecoder::decode Error: Failed to allocate AVFrame." << endl;
-		return AVERROR(ENOMEM);	// ڴ治
+	// ߴѷֱ֡Ӹã֡䣻Ϊһ
+	if (!*frame) {
+		*frame = av_frame_alloc();
+		if (!*frame) {
+			cerr << "FFmpegVideoDecoder::decode Error: Failed to allocate AVFrame." << endl;
+			return AVERROR(ENOMEM);	// ڴ治
+		}
+	}
+	else {
+		// ȷAVFrameʹǰǸɾ
+		av_frame_unref(*frame);
 	}
 
 	// avcodec ڲԶ PTS  DTS ˳Э
-	ret = avcodec_receive_frame(m_codecContext, decoded_frame);
+	ret = avcodec_receive_frame(m_codecContext, *frame);
 
 	if (ret == 0) { // ɹյһ֡
-		*frame = decoded_frame;	//֡ȨתƸ
 		return 0;
 	}
 	else {
-		av_frame_free(&decoded_frame);	// ûгɹյ֡ͷѾ AVFrame
-		*frame = nullptr;
+		// δյ֡ʱ *frame Ϊ֡Թ
 		//  ret  AVERROR(EAGAIN)Ҫ룩 AVERROR_EOFûи֡
 		// ЩԤڵķֵһǡ󡱡
 		// ֵʾ
@@ -144,11 +181,28 @@ int FFmpegVideoDecoder::decode(AVPacket* packet, AVFrame** frame) {
 	}
 }
 
+int FFmpegVideoDecoder::decodeAll(AVPacket* packet, AVFrame** frame, const FrameCallback& onFrame) {
+	if (!m_codecContext || m_codecContext->codec_id == AV_CODEC_ID_NONE) {
+		cerr << "FFmpegVideoDecoder::decodeAll Error: Decoder not initialized or has been closed." << endl;
+		return AVERROR(EINVAL);
+	}
+	return decodeAllFrames(m_codecContext, packet, frame, onFrame, "FFmpegVideoDecoder::decodeAll");
+}
+
 void FFmpegVideoDecoder::close() {
 	if (m_codecContext) {
 		avcodec_free_context(&m_codecContext);	// ͷڴ棬m_codecContext ᱻΪ nullptr
 		cout << "FFmpegVideoDecoder::close: Codec context closed and freed." << endl;
 	}
+	releaseThreads();
+}
+
+void FFmpegVideoDecoder::releaseThreads() {
+	if (m_threadCount > 0) {
+		DecoderThreadBudget::instance().release(m_threadCount);
+		m_threadCount = 0;
+	}
+	m_threadType = DecoderThreadType::NONE;
 }
 
 void FFmpegVideoDecoder::flush() {
@@ -157,6 +211,34 @@ void FFmpegVideoDecoder::flush() {
 	}
 }
 
+void FFmpegVideoDecoder::setSkipFrame(enum AVDiscard discard) {
+	if (m_codecContext) {
+		m_codecContext->skip_frame = discard;
+	}
+}
+
+void FFmpegVideoDecoder::setSkipLoopFilter(enum AVDiscard discard) {
+	if (m_codecContext) {
+		m_codecContext->skip_loop_filter = discard;
+	}
+}
+
+void FFmpegVideoDecoder::setLowDelay(bool enable) {
+	m_lowDelay = enable;
+}
+
+void FFmpegVideoDecoder::setThreading(const DecoderThreadConfig& config) {
+	m_threading = config;
+}
+
+int FFmpegVideoDecoder::getThreadCount() const {
+	return m_threadCount;
+}
+
+DecoderThreadType FFmpegVideoDecoder::getThreadType() const {
+	return m_threadType;
+}
+
 int FFmpegVideoDecoder::getWidth() const {
 	return m_codecContext ? m_codecContext->width : 0;
 }
@@ -20,78 +20,205 @@
 
 #include "../include/FrameQueue.h"
 #include <iostream>
+#include <stdexcept>	// std::runtime_error
 
 using namespace std;
 
-FrameQueue::FrameQueue(size_t max_queue_size):max_size(max_queue_size) {}
+FrameQueue::FrameQueue(size_t max_queue_size)
+	: max_size(max_queue_size > 0 ? max_queue_size : DEFAULT_RING_CAPACITY)
+{
+	m_capacity = max_size;
+	m_max_frames = max_size;
+
+	// һԤвλ֡ǣڼ䲻ٷ
+	m_slots.reset(new FrameSlot[m_capacity]);
+	for (size_t i = 0; i < m_capacity; ++i) {
+		m_slots[i].frame = av_frame_alloc();
+		if (!m_slots[i].frame) {
+			// ͷѷĲֹ֣ڴй©
+			for (size_t j = 0; j < i; ++j) {
+				av_frame_free(&m_slots[j].frame);
+			}
+			throw std::runtime_error("FrameQueue: av_frame_alloc failed for ring slot.");
+		}
+	}
+}
 
 FrameQueue::~FrameQueue() { 
 	clear(); 
+	for (size_t i = 0; i < m_capacity; ++i) {
+		av_frame_free(&m_slots[i].frame);
+	}
 }
 
-bool FrameQueue::push(AVFrame* frame) {
-	if (!frame) {
-		cerr << "FrameQueue::push: Input frame is null." << endl;
-		return false;
+size_t FrameQueue::frameBytes(const AVFrame* frame) {
+	size_t bytes = 0;
+	for (int i = 0; i < AV_NUM_DATA_POINTERS && frame->buf[i]; ++i) {
+		bytes += frame->buf[i]->size;
 	}
-
-	AVFrame* frame_clone = av_frame_alloc();
-	if (!frame_clone) {
-		cerr << "FrameQueue::push: av_frame_alloc failed." << endl;
-		return false;
+	for (int i = 0; i < frame->nb_extended_buf; ++i) {
+		bytes += frame->extended_buf[i]->size;
 	}
+	return bytes;
+}
 
-	// Ϊframeݴһµãframe_clone
-	int ret = av_frame_ref(frame_clone, frame);
-	if (ret < 0) {
-		cerr << "FrameQueue::push: av_frame_ref failed with error " << ret << endl;
-		av_frame_free(&frame_clone);
-		return false;
+bool FrameQueue::isFullLocked() const {
+	size_t unread = m_size;
+	if (unread >= m_capacity || unread >= m_max_frames) {
+		return true;
 	}
+	// ֻֽ㹻ʱЧ֤ m_min_frames ֡Ի
+	return m_max_bytes > 0 && unread >= m_min_frames &&
+		m_total_bytes.load(std::memory_order_relaxed) >= m_max_bytes;
+}
 
+size_t FrameQueue::setMemoryBudget(size_t frame_bytes, size_t max_bytes, size_t min_frames) {
 	std::unique_lock<std::mutex> lock(mutex);
-	
-	// ʱֻҪûյ abort 󣬾ͼȴ
-	while (max_size > 0 && queue.size() >= max_size && !m_abort_request.load()) {
-		//cerr << "FrameQueue::push: Queue is full. Holding frame and wait." << endl;
-		cond_producer.wait(lock);
+	size_t depth = max_size;
+	if (frame_bytes > 0 && max_bytes > 0) {
+		depth = max_bytes / frame_bytes;
+	}
+	if (depth < min_frames) {
+		depth = min_frames;
+	}
+	if (depth > max_size) {
+		depth = max_size;
+	}
+	if (depth == 0) {
+		depth = 1;
+	}
+	m_max_frames = depth;
+	m_max_bytes = max_bytes;
+	m_min_frames = min_frames;
+	lock.unlock();
+
+	// ȿܱ󣬻ѵȴе
+	cond_producer.notify_all();
+	return depth;
+}
+
+size_t FrameQueue::capacity() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return m_max_frames;
+}
+
+FrameQueue::FrameSlot* FrameQueue::waitWritableLocked(std::unique_lock<std::mutex>& lock) {
+	// ʱֻҪûյ abort 󣬾ͼȴ
+	if (isFullLocked() && !m_abort_request.load()) {
+		auto wait_start = QueueStats::now();
+		while (isFullLocked() && !m_abort_request.load()) {
+			//cerr << "FrameQueue::push: Queue is full. Holding frame and wait." << endl;
+			cond_producer.wait(lock);
+		}
+		m_stats.onProducerWait(wait_start);
 	}
 
 	// ȴٴμǷ abort 
 	if (m_abort_request.load()) {
-		//  abort µĻѣݣͷѿ¡ֹ֡ڴй©
-		av_frame_free(&frame_clone);
 		// cerr << "FrameQueue::push: Abort requested while waiting to push. Discarding frame." << endl;
-		return false;
+		return nullptr;
 	}
 
-	// ڵȴڼ䱻֪ͨEOF
+	// ڵȴڼ䱻֪ͨEOF
 	if (eof_signaled.load()) {
-		av_frame_free(&frame_clone);
-		return false;
+		return nullptr;
 	}
 
-	queue.push(frame_clone);
+	return &m_slots[m_windex];
+}
 
+void FrameQueue::publishLocked(std::unique_lock<std::mutex>& lock, QueueStats::Clock::time_point locked_at) {
+	FrameSlot& slot = m_slots[m_windex];
+	slot.bytes = frameBytes(slot.frame);
+	m_total_bytes.fetch_add(slot.bytes, std::memory_order_relaxed);
+	m_windex = (m_windex + 1) % m_capacity;
+	m_size++;
+	m_stats.onPush(m_size);
+	m_stats.onLockHold(locked_at);
 	lock.unlock();
 	cond_consumer.notify_one();
+}
+
+bool FrameQueue::push(const AVFrame* frame, int serial) {
+	if (!frame) {
+		cerr << "FrameQueue::push: Input frame is null." << endl;
+		return false;
+	}
 
+	std::unique_lock<std::mutex> lock(mutex);
+	FrameSlot* slot = waitWritableLocked(lock);
+	if (!slot) {
+		return false;
+	}
+	auto locked_at = QueueStats::now();
+
+	// Ϊframeݴһµãɲλ
+	int ret = av_frame_ref(slot->frame, frame);
+	if (ret < 0) {
+		cerr << "FrameQueue::push: av_frame_ref failed with error " << ret << endl;
+		return false;
+	}
+	slot->serial = serial;
+
+	publishLocked(lock, locked_at);
 	return true;
 }
 
-bool FrameQueue::pop(AVFrame* frame, int timeout_ms) {
+bool FrameQueue::push(AVFrame*&& frame, int serial) {
 	if (!frame) {
-		cerr << "FrameQueue::pop: Output frame parameter is null." << endl;
+		cerr << "FrameQueue::push: Input frame is null." << endl;
 		return false;
 	}
 
 	std::unique_lock<std::mutex> lock(mutex);
+	FrameSlot* slot = waitWritableLocked(lock);
+	if (!slot) {
+		return false;
+	}
+	auto locked_at = QueueStats::now();
+
+	// ֱƽݣü
+	av_frame_move_ref(slot->frame, frame);
+	slot->serial = serial;
 
-	// ΪաδյEOFźšδյжźʱ ȴ
-	while (queue.empty() && !eof_signaled.load() && !m_abort_request.load()) {
+	publishLocked(lock, locked_at);
+	return true;
+}
+
+void FrameQueue::advanceLocked() {
+	FrameSlot& slot = m_slots[m_rindex];
+	av_frame_unref(slot.frame);
+	m_total_bytes.fetch_sub(slot.bytes, std::memory_order_relaxed);
+	slot.bytes = 0;
+	m_rindex = (m_rindex + 1) % m_capacity;
+	m_size--;
+}
+
+size_t FrameQueue::purgeStaleLocked() {
+	size_t purged = 0;
+	// ɴʵ֡δ֡Ŀͷ
+	while (m_size > 0 &&
+		m_slots[m_rindex].serial < m_min_serial) {
+		advanceLocked();
+		++purged;
+	}
+	return purged;
+}
+
+bool FrameQueue::waitReadableLocked(std::unique_lock<std::mutex>& lock, int timeout_ms) {
+	// ʧЧľ֡лգճλÿɹʹ
+	bool purged = purgeStaleLocked() > 0;
+
+	// ûδ֡δյEOFźšδյжźʱ ȴ
+	while (m_size == 0 && !eof_signaled.load() && !m_abort_request.load()) {
+		if (purged) {
+			cond_producer.notify_all();
+			purged = false;
+		}
 		if (timeout_ms == 0) { // 
 			return false;
 		}
+		auto wait_start = QueueStats::now();
 		if (timeout_ms < 0) { // ޵ȴ
 			cond_consumer.wait(lock);
 		}
@@ -99,61 +226,159 @@ bool FrameQueue::pop(AVFrame* frame, int timeout_ms) {
 			// ж̵߳ĻǷΪʱ
 			if (cond_consumer.wait_for(lock, std::chrono::milliseconds(timeout_ms)) 
 				== std::cv_status::timeout) {
+				m_stats.onConsumerWait(wait_start);
 				return false; // ȴʱ
 			}
 		}
+		m_stats.onConsumerWait(wait_start);
+		purged = purgeStaleLocked() > 0 || purged;
+	}
+
+	if (purged) {
+		cond_producer.notify_all();
 	}
 
 	// 黽ѵԭ
-	// жźЧ
+	// жźЧ
 	if (m_abort_request.load()) {
 		return false;
 	}
-	// ǶΪյEOFźţΪ
-	if (queue.empty() && eof_signaled.load()) {
-		return false;
+	// ûδ֡ (յEOFźţٻ)
+	return m_size > 0;
+}
+
+AVFrame* FrameQueue::peek_readable(int timeout_ms) {
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!waitReadableLocked(lock, timeout_ms)) {
+		return nullptr;
 	}
+	return m_slots[m_rindex].frame;
+}
 
-	// Ȼǿյ (ܷٻûabort/eof)Ҳfalse
-	if (queue.empty()) {
-		return false;
+AVFrame* FrameQueue::peek(int* serial) {
+	const FrameSlot& slot = m_slots[m_rindex];
+	if (serial) {
+		*serial = slot.serial;
 	}
+	return slot.frame;
+}
+
+AVFrame* FrameQueue::peek_next(int* serial) {
+	const FrameSlot& slot = m_slots[(m_rindex + 1) % m_capacity];
+	if (serial) {
+		*serial = slot.serial;
+	}
+	return slot.frame;
+}
 
-	// Ӷȡһ֡
-	AVFrame* src_frame = queue.front();
-	queue.pop();
+void FrameQueue::next() {
+	std::unique_lock<std::mutex> lock(mutex);
+	auto locked_at = QueueStats::now();
+	advanceLocked();
+	m_stats.onPop(m_size);
+	m_stats.onLockHold(locked_at);
 	lock.unlock();
+	// ֪ͨһڵȴ
+	cond_producer.notify_one();
+}
 
-	// unrefɵģrefµ
-	av_frame_unref(frame);
-	int ret = av_frame_ref(frame, src_frame);
-	if (ret < 0) {
-		cerr << "FrameQueue::pop: av_frame_ref failed to copy to output frame. Error: " << ret << endl;
-		// ʹʧܣsrc_frame Ҳ뱻ͷ
-		av_frame_free(&src_frame);
-		// δܳɹݸ
+bool FrameQueue::pop(AVFrame* frame, int timeout_ms) {
+	if (!frame) {
+		cerr << "FrameQueue::pop: Output frame parameter is null." << endl;
+		return false;
+	}
+
+	AVFrame* src_frame = peek_readable(timeout_ms);
+	if (!src_frame) {
 		return false;
 	}
-	// ͷ src_frame  push ʱ䣬ⲿ frame ã
-	av_frame_free(&src_frame);
-	// ֪ͨһڵȴ
-	cond_producer.notify_one();
+
+	// ƽݺǰλãλе
+	av_frame_unref(frame);
+	av_frame_move_ref(frame, src_frame);
+	next();
 
 	return true;
 }
 
+size_t FrameQueue::pop_batch(AVFrame** frames, size_t max_count, int timeout_ms) {
+	if (!frames || max_count == 0) {
+		cerr << "FrameQueue::pop_batch: Invalid output parameters." << endl;
+		return 0;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!waitReadableLocked(lock, timeout_ms)) {
+		return 0;
+	}
+	auto locked_at = QueueStats::now();
+
+	size_t count = 0;
+	while (count < max_count && m_size > 0) {
+		FrameSlot& slot = m_slots[m_rindex];
+		if (slot.serial < m_min_serial) {
+			// ȡľ֡ͬ
+			advanceLocked();
+			continue;
+		}
+		av_frame_unref(frames[count]);
+		av_frame_move_ref(frames[count], slot.frame);
+		advanceLocked();
+		m_stats.onPop(m_size);
+		count++;
+	}
+	m_stats.onLockHold(locked_at);
+	lock.unlock();
+
+	// ȡֻһ
+	cond_producer.notify_one();
+	return count;
+}
+
+QueueStatsSnapshot FrameQueue::takeStats() {
+	std::unique_lock<std::mutex> lock(mutex);
+	size_t unread = m_size;
+	size_t depth = m_max_frames;
+	lock.unlock();
+
+	QueueStatsSnapshot stats = m_stats.takeSnapshot(unread);
+	stats.capacity = depth;
+	return stats;
+}
+
+size_t FrameQueue::nb_remaining() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return m_size;
+}
+
 size_t FrameQueue::size() const {
 	std::lock_guard<std::mutex> lock(mutex);
-	return queue.size();
+	return m_size;
+}
+
+void FrameQueue::invalidate(int serial) {
+	std::unique_lock<std::mutex> lock(mutex);
+	// ֻʧЧޣͷκ֡
+	if (serial > m_min_serial) {
+		m_min_serial = serial;
+	}
+	eof_signaled = false;
+	lock.unlock();
+
+	// ѵȴеߣվ֡
+	cond_producer.notify_all();
+	cond_consumer.notify_all();
 }
 
 void FrameQueue::clear() {
 	std::unique_lock<std::mutex> lock(mutex);
-	while (!queue.empty()) {
-		AVFrame* frm = queue.front();
-		queue.pop();
-		av_frame_free(&frm);
+	while (m_size > 0) {
+		av_frame_unref(m_slots[m_rindex].frame);
+		m_slots[m_rindex].bytes = 0;
+		m_rindex = (m_rindex + 1) % m_capacity;
+		m_size--;
 	}
+	m_total_bytes = 0;
 
 	// ״̬־
 	eof_signaled = false;
@@ -183,5 +408,5 @@ void FrameQueue::abort() {
 
 bool FrameQueue::is_eof() const {
 	std::lock_guard<std::mutex> lock(mutex);
-	return eof_signaled && queue.empty();
+	return eof_signaled && m_size == 0;
 }
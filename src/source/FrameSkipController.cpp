@@ -0,0 +1,127 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/FrameSkipController.h"
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// ſڸʱҪΪ
+	constexpr double OSCILLATION_SEC = 5.0;
+	// ſȴʱ
+	constexpr double MAX_RELAX_HOLD_SEC = 30.0;
+	// ٱһжϣµȼЧ (֡ѽ֡Իٵ)
+	constexpr double MIN_HOLD_WINDOWS = 1.0;
+
+	double secondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+		return std::chrono::duration<double>(to - from).count();
+	}
+}
+
+FrameSkipController::FrameSkipController(double window_sec, double escalate_ratio, double relax_sec)
+	: m_window_sec(window_sec), m_escalate_ratio(escalate_ratio), m_relax_sec(relax_sec), m_relax_hold_sec(relax_sec) {}
+
+void FrameSkipController::onFrame(bool dropped) {
+	Clock::time_point now = Clock::now();
+	if (!m_started) {
+		m_started = true;
+		m_window_start = m_last_drop = m_last_change = m_last_relax = now;
+	}
+
+	m_window_frames++;
+	if (dropped) {
+		m_window_drops++;
+		m_last_drop = now;
+	}
+
+	int level = m_level.load();
+	if (secondsBetween(m_window_start, now) >= m_window_sec) {
+		double ratio = static_cast<double>(m_window_drops) / m_window_frames;
+		bool settled = secondsBetween(m_last_change, now) >= m_window_sec * (MIN_HOLD_WINDOWS + 1.0);
+		if (ratio > m_escalate_ratio && level < MAX_LEVEL && settled) {
+			// շſָϣһηſǰһʱ
+			if (m_relaxed && secondsBetween(m_last_relax, now) < OSCILLATION_SEC) {
+				m_relax_hold_sec = std::min(m_relax_hold_sec * 2.0, MAX_RELAX_HOLD_SEC);
+			}
+			m_level = ++level;
+			m_escalations++;
+			m_last_change = now;
+			cout << "FrameSkipController: Video is falling behind (" << static_cast<int>(ratio * 100)
+				<< "% frames dropped), skip level raised to " << level << "." << endl;
+		}
+		m_window_start = now;
+		m_window_frames = 0;
+		m_window_drops = 0;
+	}
+
+	// ûж֡һ
+	if (level > 0 && secondsBetween(m_last_drop, now) >= m_relax_hold_sec &&
+		secondsBetween(m_last_change, now) >= m_relax_hold_sec) {
+		m_level = --level;
+		m_last_change = m_last_relax = now;
+		m_relaxed = true;
+		if (level == 0) {
+			m_relax_hold_sec = m_relax_sec;
+		}
+		cout << "FrameSkipController: Caught up, skip level lowered to " << level << "." << endl;
+	}
+}
+
+int FrameSkipController::getLevel() const {
+	return m_level.load();
+}
+
+uint64_t FrameSkipController::getEscalations() const {
+	return m_escalations.load();
+}
+
+AVDiscard FrameSkipController::skipFrameFor(int level) {
+	switch (level) {
+	case 0:
+	case 1:		return AVDISCARD_DEFAULT;
+	case 2:		return AVDISCARD_NONREF;
+	case 3:		return AVDISCARD_BIDIR;
+	default:	return AVDISCARD_NONKEY;
+	}
+}
+
+AVDiscard FrameSkipController::skipLoopFilterFor(int level) {
+	switch (level) {
+	case 0:		return AVDISCARD_DEFAULT;
+	case 1:
+	case 2:		return AVDISCARD_NONREF;
+	default:	return AVDISCARD_ALL;
+	}
+}
+
+const char* FrameSkipController::discardName(AVDiscard discard) {
+	switch (discard) {
+	case AVDISCARD_NONE:		return "none";
+	case AVDISCARD_DEFAULT:		return "default";
+	case AVDISCARD_NONREF:		return "nonref";
+	case AVDISCARD_BIDIR:		return "bidir";
+	case AVDISCARD_NONINTRA:	return "nonintra";
+	case AVDISCARD_NONKEY:		return "nonkey";
+	case AVDISCARD_ALL:			return "all";
+	default:					return "?";
+	}
+}
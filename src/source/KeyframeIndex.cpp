@@ -0,0 +1,245 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/KeyframeIndex.h"
+#include <algorithm>	// std::lower_bound, std::upper_bound
+#include <fstream>
+#include <cstring>		// memcmp
+#include <sys/types.h>
+#include <sys/stat.h>
+
+extern "C" {
+#include <libavutil/avutil.h>	// AV_NOPTS_VALUE
+}
+
+using namespace std;
+
+namespace {
+	// ļʽļͷ + Ŀ飬ֽд (ֻڱʹ)
+	const char INDEX_MAGIC[4] = { 'K', 'F', 'I', 'X' };
+	const uint32_t INDEX_VERSION = 1;
+	// ʱĿޣֹ𻵵Ļļ¾
+	const uint64_t MAX_INDEX_ENTRIES = 16 * 1024 * 1024;
+
+	template <typename T>
+	void writeValue(ofstream& out, const T& value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool readValue(ifstream& in, T& value) {
+		in.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return static_cast<bool>(in);
+	}
+}
+
+void KeyframeIndex::reset(int stream_index, AVRational time_base, int64_t file_size, int64_t file_mtime) {
+	m_stream_index = stream_index;
+	m_time_base = time_base;
+	m_file_size = file_size;
+	m_file_mtime = file_mtime;
+	m_entries.clear();
+	m_tail_complete = false;
+	m_dirty = false;
+	m_last_key = -1;
+	m_packets_since_key = 0;
+}
+
+void KeyframeIndex::addPacket(const AVPacket* packet) {
+	if (!packet || m_stream_index < 0 || packet->stream_index != m_stream_index) {
+		return;
+	}
+	if (!(packet->flags & AV_PKT_FLAG_KEY)) {
+		if (m_last_key >= 0) {
+			m_packets_since_key++;
+		}
+		return;
+	}
+
+	int64_t pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+	if (pts == AV_NOPTS_VALUE || packet->pos < 0) {
+		// ޷Ĺؼ֡˺Ŀ֮ǰĿΪ
+		onDiscontinuity();
+		return;
+	}
+
+	auto it = std::lower_bound(m_entries.begin(), m_entries.end(), pts,
+		[](const Entry& e, int64_t value) { return e.pts < value; });
+	int index = static_cast<int>(it - m_entries.begin());
+	if (it == m_entries.end() || it->pts != pts) {
+		Entry entry;
+		entry.pts = pts;
+		entry.pos = packet->pos;
+		m_entries.insert(it, entry);
+		m_dirty = true;
+		if (m_last_key >= index) {
+			m_last_key++;
+		}
+		if (index == static_cast<int>(m_entries.size()) - 1) {
+			m_tail_complete = false; // µĩβĿ֮δɨ
+		}
+		else {
+			// 뵽м䣺ԭ䱻𿪣ĿһĿ֮δɨ
+			m_entries[index + 1].contiguous = false;
+		}
+		if (index > 0) {
+			m_entries[index - 1].gop_packets = 0; // ǰһĿ GOP յѱ䣬δ֪
+		}
+	}
+
+	// 뱾ɨеһؼ֡ڣ֮ûؼ֡
+	if (m_last_key >= 0 && m_last_key == index - 1) {
+		Entry& prev = m_entries[index - 1];
+		Entry& cur = m_entries[index];
+		uint32_t gop_packets = m_packets_since_key + 1;
+		if (!cur.contiguous || prev.gop_packets != gop_packets) {
+			cur.contiguous = true;
+			prev.gop_packets = gop_packets;
+			m_dirty = true;
+		}
+	}
+	m_last_key = index;
+	m_packets_since_key = 0;
+}
+
+void KeyframeIndex::onDiscontinuity() {
+	m_last_key = -1;
+	m_packets_since_key = 0;
+}
+
+void KeyframeIndex::onEndOfFile() {
+	if (m_last_key >= 0 && m_last_key == static_cast<int>(m_entries.size()) - 1 && !m_tail_complete) {
+		m_entries.back().gop_packets = m_packets_since_key + 1;
+		m_tail_complete = true;
+		m_dirty = true;
+	}
+	onDiscontinuity();
+}
+
+bool KeyframeIndex::lookup(int64_t target_pts, Entry& entry) const {
+	// һ PTS ĿĿ
+	auto next = std::upper_bound(m_entries.begin(), m_entries.end(), target_pts,
+		[](int64_t value, const Entry& e) { return value < e.pts; });
+	if (next == m_entries.begin()) {
+		return false; // Ŀڵһ֪ؼ֡
+	}
+	// Ŀ [found, next) 뱻ɨпܻδ֪Ĺؼ֡
+	if (next == m_entries.end() ? !m_tail_complete : !next->contiguous) {
+		return false;
+	}
+	entry = *(next - 1);
+	return true;
+}
+
+bool KeyframeIndex::load(const std::string& path) {
+	ifstream in(path, ios::binary);
+	if (!in) {
+		return false;
+	}
+
+	char magic[4] = {};
+	uint32_t version = 0;
+	int64_t file_size = 0, file_mtime = 0;
+	int32_t stream_index = 0, tb_num = 0, tb_den = 0;
+	uint8_t tail_complete = 0;
+	uint64_t count = 0;
+	in.read(magic, sizeof(magic));
+	if (!in || memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+		!readValue(in, version) || version != INDEX_VERSION ||
+		!readValue(in, file_size) || !readValue(in, file_mtime) ||
+		!readValue(in, stream_index) || !readValue(in, tb_num) || !readValue(in, tb_den) ||
+		!readValue(in, tail_complete) || !readValue(in, count)) {
+		return false;
+	}
+	// ýļѱ仯ֲͬʧЧ
+	if (file_size != m_file_size || file_mtime != m_file_mtime || stream_index != m_stream_index ||
+		tb_num != m_time_base.num || tb_den != m_time_base.den || count > MAX_INDEX_ENTRIES) {
+		return false;
+	}
+
+	std::vector<Entry> entries(static_cast<size_t>(count));
+	for (Entry& e : entries) {
+		uint8_t contiguous = 0;
+		if (!readValue(in, e.pts) || !readValue(in, e.pos) || !readValue(in, e.gop_packets) || !readValue(in, contiguous)) {
+			return false;
+		}
+		e.contiguous = contiguous != 0;
+	}
+	for (size_t i = 1; i < entries.size(); ++i) {
+		if (entries[i].pts <= entries[i - 1].pts) {
+			return false; // 𻵵Ļ
+		}
+	}
+
+	m_entries.swap(entries);
+	m_tail_complete = tail_complete != 0;
+	m_dirty = false;
+	m_last_key = -1;
+	m_packets_since_key = 0;
+	return true;
+}
+
+bool KeyframeIndex::save(const std::string& path) {
+	ofstream out(path, ios::binary | ios::trunc);
+	if (!out) {
+		return false;
+	}
+	out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+	writeValue(out, INDEX_VERSION);
+	writeValue(out, m_file_size);
+	writeValue(out, m_file_mtime);
+	writeValue(out, static_cast<int32_t>(m_stream_index));
+	writeValue(out, static_cast<int32_t>(m_time_base.num));
+	writeValue(out, static_cast<int32_t>(m_time_base.den));
+	writeValue(out, static_cast<uint8_t>(m_tail_complete ? 1 : 0));
+	writeValue(out, static_cast<uint64_t>(m_entries.size()));
+	for (const Entry& e : m_entries) {
+		writeValue(out, e.pts);
+		writeValue(out, e.pos);
+		writeValue(out, e.gop_packets);
+		writeValue(out, static_cast<uint8_t>(e.contiguous ? 1 : 0));
+	}
+	out.close();
+	if (!out) {
+		return false;
+	}
+	m_dirty = false;
+	return true;
+}
+
+bool KeyframeIndex::statFile(const std::string& path, int64_t& file_size, int64_t& file_mtime) {
+#ifdef _WIN32
+	struct _stat64 st;
+	if (_stat64(path.c_str(), &st) != 0) {
+		return false;
+	}
+#else
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0) {
+		return false;
+	}
+#endif
+	if ((st.st_mode & S_IFMT) != S_IFREG) {
+		return false;
+	}
+	file_size = static_cast<int64_t>(st.st_size);
+	file_mtime = static_cast<int64_t>(st.st_mtime);
+	return true;
+}
@@ -0,0 +1,267 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/MappedFileIOContext.h"
+#include <iostream>
+#include <cstring>		// memcpy, strcmp, strncmp
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFileIOContext::~MappedFileIOContext() {
+	close();
+}
+
+bool MappedFileIOContext::isLocalFile(const char* url) {
+	if (!url) {
+		return false;
+	}
+	const char* protocol = avio_find_protocol_name(url);
+	return protocol && strcmp(protocol, "file") == 0;
+}
+
+int MappedFileIOContext::open(const char* url) {
+	close();
+
+	//  FFmpeg  file Эһ£ȥѡ "file:" ǰ׺
+	std::string path = url;
+	if (path.compare(0, 5, "file:") == 0) {
+		path.erase(0, 5);
+	}
+	if (!mapFile(path)) {
+		return AVERROR(EIO);
+	}
+
+	unsigned char* io_buffer = static_cast<unsigned char*>(av_malloc(IO_BUFFER_SIZE));
+	if (!io_buffer) {
+		unmapFile();
+		return AVERROR(ENOMEM);
+	}
+	m_avio = avio_alloc_context(io_buffer, IO_BUFFER_SIZE, 0, this,
+		&MappedFileIOContext::readCallback, nullptr, &MappedFileIOContext::seekCallback);
+	if (!m_avio) {
+		av_free(io_buffer);
+		unmapFile();
+		return AVERROR(ENOMEM);
+	}
+	m_avio->seekable = AVIO_SEEKABLE_NORMAL;
+	// ȡ () ƹڲ壬ӳֱӸƵߵĻ
+	m_avio->direct = 1;
+
+	m_pos = 0;
+	m_advised_end = 0;
+	adviseAhead();
+
+	cout << "MappedFileIOContext: Mapped " << (m_size >> 20) << " MB from " << path << "." << endl;
+	return 0;
+}
+
+void MappedFileIOContext::close() {
+	if (m_avio) {
+		av_freep(&m_avio->buffer);
+		avio_context_free(&m_avio);
+	}
+	unmapFile();
+}
+
+int MappedFileIOContext::readCallback(void* opaque, uint8_t* buf, int buf_size) {
+	auto self = static_cast<MappedFileIOContext*>(opaque);
+	int64_t remaining = self->m_size - self->m_pos;
+	if (remaining <= 0) {
+		return AVERROR_EOF;
+	}
+	int n = remaining < buf_size ? static_cast<int>(remaining) : buf_size;
+	memcpy(buf, self->m_data + self->m_pos, n);
+	self->m_pos += n;
+
+	// λýӽʾյʱǰʾһ
+	if (self->m_pos + static_cast<int64_t>(ADVISE_WINDOW / 2) > self->m_advised_end) {
+		self->adviseAhead();
+	}
+	return n;
+}
+
+int64_t MappedFileIOContext::seekCallback(void* opaque, int64_t offset, int whence) {
+	auto self = static_cast<MappedFileIOContext*>(opaque);
+	if (whence & AVSEEK_SIZE) {
+		return self->m_size;
+	}
+	int64_t target = 0;
+	switch (whence & ~AVSEEK_FORCE) {
+	case SEEK_SET:
+		target = offset;
+		break;
+	case SEEK_CUR:
+		target = self->m_pos + offset;
+		break;
+	case SEEK_END:
+		target = self->m_size + offset;
+		break;
+	default:
+		return AVERROR(EINVAL);
+	}
+	if (target < 0) {
+		return AVERROR(EINVAL);
+	}
+	self->m_pos = target;
+	// ʾʱλʾ
+	if (target < self->m_advised_end - static_cast<int64_t>(ADVISE_WINDOW) || target >= self->m_advised_end) {
+		self->m_advised_end = target;
+		self->adviseAhead();
+	}
+	return target;
+}
+
+void MappedFileIOContext::adviseAhead() {
+	if (!m_data || m_pos >= m_size) {
+		return;
+	}
+	int64_t start = m_advised_end > m_pos ? m_advised_end : m_pos;
+	int64_t end = m_pos + static_cast<int64_t>(ADVISE_WINDOW);
+	if (end > m_size) {
+		end = m_size;
+	}
+	if (start >= end) {
+		return;
+	}
+
+#ifdef _WIN32
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = const_cast<uint8_t*>(m_data + start);
+	range.NumberOfBytes = static_cast<SIZE_T>(end - start);
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+#else
+	// madvise Ҫַҳ
+	static const int64_t page_size = sysconf(_SC_PAGESIZE);
+	int64_t aligned_start = start - start % page_size;
+	madvise(const_cast<uint8_t*>(m_data + aligned_start), static_cast<size_t>(end - aligned_start), MADV_WILLNEED);
+#endif
+	m_advised_end = end;
+}
+
+#ifdef _WIN32
+
+bool MappedFileIOContext::mapFile(const std::string& path) {
+	// FFmpeg  Windows ° UTF-8 ·ﱣһ
+	int wlen = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+	if (wlen <= 0) {
+		return false;
+	}
+	std::wstring wpath(static_cast<size_t>(wlen), L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], wlen);
+
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0 ||
+		static_cast<uint64_t>(file_size.QuadPart) > static_cast<uint64_t>(SIZE_MAX)) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		CloseHandle(file);
+		return false;
+	}
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	m_file_handle = file;
+	m_mapping_handle = mapping;
+	m_data = static_cast<const uint8_t*>(data);
+	m_size = file_size.QuadPart;
+	return true;
+}
+
+void MappedFileIOContext::unmapFile() {
+	if (m_data) {
+		UnmapViewOfFile(m_data);
+		m_data = nullptr;
+	}
+	if (m_mapping_handle) {
+		CloseHandle(m_mapping_handle);
+		m_mapping_handle = nullptr;
+	}
+	if (m_file_handle) {
+		CloseHandle(m_file_handle);
+		m_file_handle = nullptr;
+	}
+	m_size = 0;
+	m_pos = 0;
+}
+
+#else
+
+bool MappedFileIOContext::mapFile(const std::string& path) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	// ֻӳͨļ (ܵ豸 FFmpeg Ĭ IO)
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+		static_cast<uint64_t>(st.st_size) > static_cast<uint64_t>(SIZE_MAX)) {
+		::close(fd);
+		return false;
+	}
+	void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	// ӳ佨󼴿ɹرļ
+	::close(fd);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+	madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+	m_data = static_cast<const uint8_t*>(data);
+	m_size = st.st_size;
+	return true;
+}
+
+void MappedFileIOContext::unmapFile() {
+	if (m_data) {
+		munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+		m_data = nullptr;
+	}
+	m_size = 0;
+	m_pos = 0;
+}
+
+#endif
@@ -21,6 +21,10 @@
 #include <fstream>      // ļ·֤
 #include <stdexcept>    // std::runtime_error
 #include <chrono>       // SDL_Delay  PacketQueue ʱ
+#include <sstream>      // ͳƵ JSON 
+#include <cmath>        // std::isnan
+#include <algorithm>    // std::find
+#include <limits>       // std::numeric_limits
 
 // PacketQueue.h  FrameQueue.h ͨ MediaPlayer.h 
 #include "../include/MediaPlayer.h"
@@ -67,10 +71,8 @@ void MediaPlayer::init_components(const std::string& filepath) {
     //  0: ʼ Ϣ޹ص
     // Щʧ ( bad_alloc)ֱ׳쳣
     // PacketQueue Ĵ init_demuxer_and_decoders()
-    const int MAX_VIDEO_FRAMES = 5;
-    const int MAX_AUDIO_FRAMES = 10;
-
-    m_videoFrameQueue = std::make_unique<FrameQueue>(MAX_VIDEO_FRAMES);
+    // Ƶ֡еʵڽʼڴԤȷ
+    m_videoFrameQueue = std::make_unique<FrameQueue>(MAX_VIDEO_FRAMES); // Ⱦгʾе֡вһ֡
     m_audioFrameQueue = std::make_unique<FrameQueue>(MAX_AUDIO_FRAMES);
     m_clockManager = std::make_unique<ClockManager>();
     
@@ -79,6 +81,19 @@ void MediaPlayer::init_components(const std::string& filepath) {
     //  1: ʼ FFmpeg Դ
     init_ffmpeg_resources(filepath);
 
+    // ȷʽ󣬰ֽ֡Ƶ֡
+    if (m_videoDecoder && videoStreamIndex >= 0) {
+        int frame_bytes = av_image_get_buffer_size(m_videoDecoder->getPixelFormat(),
+            m_videoDecoder->getWidth(), m_videoDecoder->getHeight(), 1);
+        size_t depth = m_videoFrameQueue->setMemoryBudget(frame_bytes > 0 ? static_cast<size_t>(frame_bytes) : 0,
+            VIDEO_FRAME_BUDGET_MB * 1024 * 1024, MIN_VIDEO_FRAMES);
+        cout << "MediaPlayer: Video frame queue depth " << depth << " (frame size " << frame_bytes
+            << " bytes, budget " << VIDEO_FRAME_BUDGET_MB << " MB)." << endl;
+        if (m_debugStats) {
+            m_debugStats->vf_capacity = static_cast<int>(depth);
+        }
+    }
+
     // ȷϢ󣬳ʼʱӹ
     if (m_clockManager) {
         bool has_audio = (audioStreamIndex >= 0);
@@ -103,14 +118,15 @@ void MediaPlayer::init_ffmpeg_resources(const std::string& filepath) {
     m_decodingVideoPacket = av_packet_alloc();
     if (!m_decodingVideoPacket) throw std::runtime_error("FFmpeg Init Error: Could not allocate video decoding packet.");
 
-    m_decodingAudioPacket = av_packet_alloc();
-    if (!m_decodingAudioPacket) throw std::runtime_error("FFmpeg Init Error: Could not allocate audio decoding packet.");
-
-    m_renderingVideoFrame = av_frame_alloc();
-    if (!m_renderingVideoFrame) throw std::runtime_error("FFmpeg Init Error: Could not allocate video rendering frame.");
+    for (AVPacket*& pkt : m_decodingAudioPackets) {
+        pkt = av_packet_alloc();
+        if (!pkt) throw std::runtime_error("FFmpeg Init Error: Could not allocate audio decoding packet.");
+    }
 
-    m_renderingAudioFrame = av_frame_alloc();
-    if (!m_renderingAudioFrame) throw std::runtime_error("FFmpeg Init Error: Could not allocate audio rendering frame");
+    for (AVFrame*& frame : m_renderingAudioFrames) {
+        frame = av_frame_alloc();
+        if (!frame) throw std::runtime_error("FFmpeg Init Error: Could not allocate audio rendering frame");
+    }
 
     // ʵ (ʱֻǿտ)
     m_videoDecoder = std::make_unique<FFmpegVideoDecoder>();
@@ -186,6 +202,7 @@ void MediaPlayer::init_sdl_audio_renderer() {
     cout << "MediaPlayer: Initializing SDL Audio Renderer..." << endl;
 
     m_audioRenderer = std::make_unique<SDLAudioRenderer>();
+    m_audioRenderer->setLowLatency(m_low_latency);
 
     // ӽȡƵ
     int sampleRate = m_audioDecoder->getSampleRate();
@@ -256,7 +273,14 @@ int MediaPlayer::init_demuxer_and_decoders(const string& filepath) {
     }
 
     // 򿪽⸴
-    m_demuxer = std::make_unique<FFmpegDemuxer>();
+    auto demuxer = std::make_unique<FFmpegDemuxer>();
+    demuxer->setReadAhead(DEMUX_READ_AHEAD_MB * 1024 * 1024);
+    demuxer->setMemoryMappedInput(DEMUX_USE_MMAP);
+    demuxer->setKeyframeIndexCache(DEMUX_KEYFRAME_INDEX);
+    demuxer->setLowLatency(LIVE_LOW_LATENCY);
+    // ʱֻʵʱЧ
+    demuxer->setTimeouts(LIVE_OPEN_TIMEOUT_MS, LIVE_RECONNECT ? LIVE_READ_TIMEOUT_MS : 0);
+    m_demuxer = std::move(demuxer);
     if (!m_demuxer->open(filepath.c_str())) {
         cerr << "MediaPlayer Error: Demuxer failed to open input: " << filepath << endl;
         return -1;
@@ -268,6 +292,18 @@ int MediaPlayer::init_demuxer_and_decoders(const string& filepath) {
     bool isLive = m_demuxer->isLiveStream();
     bool block_on_full = !isLive; // ļ(Live)ҪֱҪ
     cout << "MediaPlayer: Stream Mode: " << (isLive ? "LIVE (Drop on full)" : "LOCAL/VOD (Block on full)") << endl;
+    m_low_latency = LIVE_LOW_LATENCY && isLive;
+    if (m_low_latency) {
+        cout << "MediaPlayer: Low-latency live mode enabled (jitter target " << LOW_LATENCY_JITTER_SEC * 1000 << " ms)." << endl;
+    }
+
+    // ֽԤ㣺ֹڰ/ʱδʱռùڴ
+    const size_t video_max_bytes = (isLive ? 16 : 64) * 1024 * 1024;
+    const size_t audio_max_bytes = (isLive ? 2 : 8) * 1024 * 1024;
+    // λ (Ӳ)ļʱ/ֽԤΪԤ㣬 StreamPacketBuffer ͳһȣ
+    // ԴԤӦİ֯ʱԻ·λľ
+    const size_t video_ring_size = isLive ? 150 : 600;
+    const size_t audio_ring_size = isLive ? 200 : 1000;
 
     // 
     videoStreamIndex = m_demuxer->findStream(AVMEDIA_TYPE_VIDEO);
@@ -286,17 +322,17 @@ int MediaPlayer::init_demuxer_and_decoders(const string& filepath) {
         if (time_base.den == 0) {
             // ĬΪ
             cerr << "MediaPlayer Warning: Invalid video time_base { " << time_base.num << ", " << time_base.den << " }. Using default PacketQueue settings." << endl;
-            m_videoPacketQueue = std::make_unique<PacketQueue>(150, 0, block_on_full);
+            m_videoPacketQueue = std::make_unique<PacketQueue>(video_ring_size, 0, block_on_full, video_max_bytes);
         }
         else {
-            // ļһĻ壬ֱСһ
-            double target_duration_sec = isLive ? 2.0 : 10.0;
+            // ļһĻ壬ֱСһ㣬ӳģʽС
+            double target_duration_sec = m_low_latency ? LOW_LATENCY_QUEUE_SEC : (isLive ? 2.0 : 10.0);
             int64_t max_duration_ts = static_cast<int64_t>(target_duration_sec / av_q2d(time_base));
 
             cout << "MediaPlayer: Video PacketQueue configured for " << target_duration_sec
-                << "s buffer. Strategy: " << (block_on_full ? "BLOCK" : "DROP") << endl;
+                << "s / " << (video_max_bytes >> 20) << "MB buffer. Strategy: " << (block_on_full ? "BLOCK" : "DROP") << endl;
 
-            m_videoPacketQueue = std::make_unique<PacketQueue>(150, max_duration_ts, block_on_full);
+            m_videoPacketQueue = std::make_unique<PacketQueue>(video_ring_size, max_duration_ts, block_on_full, video_max_bytes);
         }
     }
 
@@ -304,17 +340,17 @@ int MediaPlayer::init_demuxer_and_decoders(const string& filepath) {
         AVRational time_base = m_demuxer->getTimeBase(audioStreamIndex);
         if (time_base.den == 0) {
             cerr << "MediaPlayer Warning: Invalid audio time_base { " << time_base.num << ", " << time_base.den << " }. Using default PacketQueue settings." << endl;
-            m_audioPacketQueue = std::make_unique<PacketQueue>(200, 0, block_on_full);
+            m_audioPacketQueue = std::make_unique<PacketQueue>(audio_ring_size, 0, block_on_full, audio_max_bytes);
         }
         else {
             // ƵõøһЩ
-            double target_duration_sec = isLive ? 3.0 : 15.0;
+            double target_duration_sec = m_low_latency ? LOW_LATENCY_QUEUE_SEC : (isLive ? 3.0 : 15.0);
             int64_t max_duration_ts = static_cast<int64_t>(target_duration_sec / av_q2d(time_base));
 
             cout << "MediaPlayer: Audio PacketQueue configured for " << target_duration_sec
-                << "s buffer. Strategy: " << (block_on_full ? "BLOCK" : "DROP") << endl;
+                << "s / " << (audio_max_bytes >> 20) << "MB buffer. Strategy: " << (block_on_full ? "BLOCK" : "DROP") << endl;
 
-            m_audioPacketQueue = std::make_unique<PacketQueue>(200, max_duration_ts, block_on_full);
+            m_audioPacketQueue = std::make_unique<PacketQueue>(audio_ring_size, max_duration_ts, block_on_full, audio_max_bytes);
         }
     }
 
@@ -326,12 +362,28 @@ int MediaPlayer::init_demuxer_and_decoders(const string& filepath) {
         // ȡƵʱ
         AVRational videoTimeBase = m_demuxer->getTimeBase(videoStreamIndex);
 
+        m_videoDecoder->setLowDelay(m_low_latency);
+        DecoderThreadConfig threading;
+        threading.type = VIDEO_DECODE_THREAD_TYPE;
+        threading.thread_count = VIDEO_DECODE_THREADS;
+        m_videoDecoder->setThreading(threading);
+        if (DECODE_THREAD_BUDGET > 0) {
+            DecoderThreadBudget::instance().setLimit(DECODE_THREAD_BUDGET);
+        }
         if (!pVideoCodecParams || !m_videoDecoder->init(pVideoCodecParams, videoTimeBase)) {
             cerr << "MediaPlayer Warning: Failed to initialize video decoder. Ignoring video." << endl;
             videoStreamIndex = -1;
+            m_demuxer->selectStream(AVMEDIA_TYPE_VIDEO, -1); // ٶ޷
         }
         else {
             cout << "MediaPlayer: Video decoder initialized successfully." << endl;
+            if (m_debugStats) {
+                m_debugStats->decode_threads = m_videoDecoder->getThreadCount();
+                m_debugStats->decode_thread_type = static_cast<int>(m_videoDecoder->getThreadType());
+            }
+            if (FRAME_SKIP_ADAPTIVE) {
+                m_frameSkip.reset(new FrameSkipController(FRAME_SKIP_WINDOW_SEC, FRAME_SKIP_DROP_RATIO, FRAME_SKIP_RELAX_SEC));
+            }
         }
     }
     else {
@@ -346,9 +398,16 @@ int MediaPlayer::init_demuxer_and_decoders(const string& filepath) {
         if (!pAudioCodecParams || !m_audioDecoder->init(pAudioCodecParams, audioTimeBase, m_clockManager.get())) {
             cerr << "MediaPlayer Warning: Failed to initialize audio decoder. Ignoring audio." << endl;
             audioStreamIndex = -1;
+            m_demuxer->selectStream(AVMEDIA_TYPE_AUDIO, -1);
         }
         else {
             cout << "MediaPlayer: Audio decoder initialized successfully." << endl;
+            if (m_debugStats) {
+                std::vector<int> tracks = m_demuxer->getStreamIndices(AVMEDIA_TYPE_AUDIO);
+                auto it = std::find(tracks.begin(), tracks.end(), audioStreamIndex.load());
+                m_debugStats->audio_track = static_cast<int>(it - tracks.begin()) + 1;
+                m_debugStats->audio_track_count = static_cast<int>(tracks.size());
+            }
         }
     }
     else {
@@ -361,6 +420,35 @@ int MediaPlayer::init_demuxer_and_decoders(const string& filepath) {
         return -1;
     }
 
+    // ļѸ· PacketQueue ͳһĶ·ȣֻл㹻ʱͣȡ
+    // ֱɸаԤ㶪ӳ٣װֹ̲߳ͣȡ
+    if (!isLive) {
+        m_packetBuffer = std::make_unique<StreamPacketBuffer>(video_max_bytes + audio_max_bytes);
+        if (videoStreamIndex >= 0) {
+            m_packetBuffer->addStream(videoStreamIndex, m_videoPacketQueue.get());
+        }
+        if (audioStreamIndex >= 0) {
+            m_packetBuffer->addStream(audioStreamIndex, m_audioPacketQueue.get());
+        }
+        cout << "MediaPlayer: Interleaved packet buffer enabled (total cap "
+            << ((video_max_bytes + audio_max_bytes) >> 20) << "MB)." << endl;
+    }
+    else if (LIVE_TIMESHIFT) {
+        m_timeshift = std::make_unique<TimeshiftBuffer>(TIMESHIFT_MAX_SEC, TIMESHIFT_MAX_MB * 1024 * 1024);
+        if (m_debugStats) {
+            m_debugStats->timeshift_window_sec = 0.0;
+        }
+        cout << "MediaPlayer: Live timeshift enabled (window " << TIMESHIFT_MAX_SEC << "s / "
+            << TIMESHIFT_MAX_MB << "MB)." << endl;
+    }
+    if (isLive) {
+        m_recorder = std::make_unique<StreamRecorder>(std::string(RECORD_FORMAT), std::string(RECORD_PATH_PREFIX),
+            RECORD_SEGMENT_SEC, RECORD_QUEUE_MB * 1024 * 1024);
+        if (RECORD_ON_START) {
+            m_record_request = 1;
+        }
+    }
+
     cout << "MediaPlayer: FFmpeg demuxer and decoders initialization process finished." << endl;
     return 0;
 }
@@ -390,7 +478,14 @@ int MediaPlayer::handle_event(const SDL_Event& event) {
                 // --- ָ ---
                 cout << "MediaPlayer: Resuming from PAUSED..." << endl;
                 
-                if (isLive) {
+                if (isLive && m_timeshift) {
+                    // ֱ - ʱƻָ
+                    // ͣڼݶʱƻкͽͣͣ뱾ļһֱӼ
+                    cout << "MediaPlayer: Resuming LIVE stream from the timeshift buffer." << endl;
+                    if (m_clockManager) m_clockManager->resume();
+                    setPlayerState(PlayerState::PLAYING);
+                }
+                else if (isLive) {
                     // ֱ - ͻָ
                     // ͣڼ۵ľ޴ӳ
                     cout << "MediaPlayer: Heavy Resync for LIVE mode." << endl;
@@ -432,6 +527,54 @@ int MediaPlayer::handle_event(const SDL_Event& event) {
                 // Ҫnotify̻߳һѭʱԶ
             }
         }
+        // TabлϢҳ ( / ͳ)
+        if (event.key.keysym.sym == SDLK_TAB && m_debugStats) {
+            m_debugStats->osd_page = (m_debugStats->osd_page.load() + 1) % 2;
+            // ͣʱҲػ棬ҳɼ
+            if (m_videoRenderer) {
+                m_videoRenderer->refresh();
+            }
+        }
+        // ת/ҷ 5 룬/· 60 룬Home صͷּ 0-9 ʱ 0%~90%
+        // ס Shift ʱΪ֡ȷתڹؼ֡ (ʵʱʱƴתHome ص)
+        {
+            SeekMode mode = (event.key.keysym.mod & KMOD_SHIFT) ? SeekMode::ACCURATE : SeekMode::KEYFRAME;
+            SDL_Keycode key = event.key.keysym.sym;
+            if (key == SDLK_LEFT) {
+                seekRelative(-SEEK_STEP_SHORT_SEC, mode);
+            }
+            else if (key == SDLK_RIGHT) {
+                seekRelative(SEEK_STEP_SHORT_SEC, mode);
+            }
+            else if (key == SDLK_DOWN) {
+                seekRelative(-SEEK_STEP_LONG_SEC, mode);
+            }
+            else if (key == SDLK_UP) {
+                seekRelative(SEEK_STEP_LONG_SEC, mode);
+            }
+            else if (key == SDLK_HOME && m_demuxer) {
+                // ʱתĿ궼Ǿʱʼʱ䲻Ϊ 0 ļ ( MPEG-TS) Ҫʼʱ
+                seek(m_demuxer->getStartTime(), mode);
+            }
+            else if (key >= SDLK_0 && key <= SDLK_9 && m_demuxer) {
+                double duration = m_demuxer->getDuration();
+                if (duration > 0.0) {
+                    seek(m_demuxer->getStartTime() + duration * (key - SDLK_0) / 10.0, mode);
+                }
+            }
+        }
+        // End ʱλûصֱ
+        if (event.key.keysym.sym == SDLK_END) {
+            jumpToLive();
+        }
+        // R ʼ/ֹͣ¼ʵʱ
+        if (event.key.keysym.sym == SDLK_r) {
+            toggleRecording();
+        }
+        // A лһ
+        if (event.key.keysym.sym == SDLK_a) {
+            cycleAudioTrack();
+        }
         break;
 
     case SDL_WINDOWEVENT:
@@ -504,19 +647,18 @@ void MediaPlayer::resync_after_pause() {
         m_audioRenderer->flushBuffers();
     }
 
-    // ж
-    if (m_videoPacketQueue) m_videoPacketQueue->clear();
-    if (m_audioPacketQueue) m_audioPacketQueue->clear();
-    if (m_videoFrameQueue) m_videoFrameQueue->clear();
-    if (m_audioFrameQueue) m_audioFrameQueue->clear();
+    // ʹжеľʧЧֻʧЧޣO(1) ɣڴ߳ͷ
+    // ɽ/Ⱦ߳ڳʱգҪռʱ
+    int new_serial = m_seek_serial.load();
+    if (m_videoPacketQueue) m_videoPacketQueue->invalidate(new_serial);
+    if (m_audioPacketQueue) m_audioPacketQueue->invalidate(new_serial);
+    if (m_videoFrameQueue) m_videoFrameQueue->invalidate(new_serial);
+    if (m_audioFrameQueue) m_audioFrameQueue->invalidate(new_serial);
+    // ݲЧ壬ͣȡĽװָ߳
+    if (m_packetBuffer) m_packetBuffer->wake();
 
-    // ˢ½ ( ffmpeg ڲ)
-    if (m_videoDecoder) m_videoDecoder->flush();
-    if (m_audioDecoder) m_audioDecoder->flush();
+    // ƵȾڲ״̬ɸԵĹ߳кʱλڽеĽ벢
 
-    // ˢƵȾ״̬
-    if (m_videoRenderer) m_videoRenderer->flush();
-    
     // ս⸴ڲ IO 
     if (m_demuxer) {
         m_demuxer->flushIO();
@@ -546,6 +688,308 @@ void MediaPlayer::resync_after_pause() {
     cout << "MediaPlayer: Resync complete." << endl;
 }
 
+void MediaPlayer::seek(double target_sec, SeekMode mode) {
+    if (!m_demuxer) {
+        return;
+    }
+    bool isLive = m_demuxer->isLiveStream();
+    if (isLive && !m_timeshift) {
+        cout << "MediaPlayer: Seek is not supported for live streams without timeshift." << endl;
+        return;
+    }
+
+    // ʵʱĿɽװ߳̽ضϵʱƴڣļضϵ [ʼʱ, ʼʱ + ʱ]
+    double duration = m_demuxer->getDuration();
+    double start = m_demuxer->getStartTime();
+    if (!isLive && target_sec < start) {
+        target_sec = start;
+    }
+    if (!isLive && duration > 0.0 && target_sec > start + duration) {
+        target_sec = start + duration;
+    }
+
+    // ֻ¼ɽװִ߳Уֻµһ
+    {
+        std::lock_guard<std::mutex> lock(m_seek_mutex);
+        m_seek_req_target = target_sec;
+        m_seek_req_mode = mode;
+        m_seek_req_counter = SDL_GetPerformanceCounter();
+        m_seek_pending = true;
+    }
+    m_last_seek_target = std::isinf(target_sec) ? m_live_edge_sec.load() : target_sec;
+    m_seek_in_flight = true;
+    cout << "MediaPlayer: Seek requested to " << target_sec << "s ("
+        << (mode == SeekMode::ACCURATE ? "accurate" : "keyframe") << ")." << endl;
+
+    // ѿܴڵȴеĽװ߳ (ͣ㹻Ѷβ)
+    {
+        std::lock_guard<std::mutex> lock(m_state_mutex);
+    }
+    m_state_cond.notify_all();
+    if (m_packetBuffer) m_packetBuffer->wake();
+}
+
+void MediaPlayer::seekRelative(double delta_sec, SeekMode mode) {
+    double base = std::nan("");
+    if (m_seek_in_flight.load()) {
+        // һתĻδ֣ĿΪ׼ۼ
+        base = m_last_seek_target.load();
+    }
+    else if (m_clockManager) {
+        base = m_clockManager->getMasterClockTime();
+        if (std::isnan(base)) {
+            base = m_clockManager->getVideoClockTime();
+        }
+    }
+    if (std::isnan(base)) {
+        base = m_last_seek_target.load();
+    }
+    seek(base + delta_sec, mode);
+}
+
+void MediaPlayer::jumpToLive() {
+    if (!m_timeshift) {
+        return;
+    }
+    // ΪֱԵĿ꣬ɽװ߳䵽µĹؼ֡
+    seek(std::numeric_limits<double>::infinity());
+}
+
+double MediaPlayer::getLastSeekLatencyMs() const {
+    if (!m_debugStats || m_debugStats->seek_count.load() == 0) {
+        return -1.0;
+    }
+    return m_debugStats->seek_last_ms.load();
+}
+
+void MediaPlayer::handle_seek_request() {
+    double target = 0.0;
+    SeekMode mode = SeekMode::KEYFRAME;
+    Uint64 requested_at = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_seek_mutex);
+        if (!m_seek_pending) return;
+        target = m_seek_req_target;
+        mode = m_seek_req_mode;
+        requested_at = m_seek_req_counter;
+        m_seek_pending = false;
+    }
+
+    cout << "MediaPlayer: Executing seek to " << target << "s..." << endl;
+    if (m_timeshift) {
+        // ʵʱֻƶʱƻĶα꣬Ӻͽ⸴Ӱ죻αڹؼ֡
+        // Ŀ곬ĩ ( jumpToLive) صֱԵ
+        bool to_live = std::isinf(target) || target >= m_timeshift->getEndTime();
+        double landed = to_live ? m_timeshift->seekToLatestKeyframe() : m_timeshift->seek(target);
+        if (std::isnan(landed)) {
+            cerr << "MediaPlayer: Timeshift buffer has no keyframe yet, seek ignored." << endl;
+            m_seek_in_flight = false;
+            return;
+        }
+        cout << "MediaPlayer: Timeshift cursor moved to " << landed << "s" << (to_live ? " (live edge)." : ".") << endl;
+        set_timeshifted(!to_live);
+        if (to_live) {
+            target = landed;
+        }
+    }
+    else if (m_demuxer->seek(target) < 0) {
+        cerr << "MediaPlayer: Seek failed, continuing from current position." << endl;
+        m_seek_in_flight = false;
+        return;
+    }
+
+    begin_seek_serial(target, mode, requested_at);
+}
+
+void MediaPlayer::begin_seek_serial(double target, SeekMode mode, Uint64 requested_at) {
+    // µĲУȷתĿ֡ӳٲ󶨵
+    int new_serial = ++m_seek_serial;
+    m_accurate_seek_target = target;
+    m_accurate_seek_serial = (mode == SeekMode::ACCURATE) ? new_serial : -1;
+    // ͣڼתҪָźʾʱӳͳ
+    if (videoStreamIndex >= 0 && m_playerState.load() != PlayerState::PAUSED) {
+        m_seek_latency_start = requested_at;
+        m_seek_latency_serial = new_serial;
+    }
+    else {
+        m_seek_latency_serial = -1;
+        m_seek_in_flight = false;
+    }
+
+    //  SDL Ƶ豸еľ
+    if (m_audioRenderer) {
+        m_audioRenderer->flushBuffers();
+    }
+
+    // ͬͬ;İֻ֡ʧЧ (O(1))ɸ߳ڳʱҪſչ߳
+    if (m_videoPacketQueue) m_videoPacketQueue->invalidate(new_serial);
+    if (m_audioPacketQueue) m_audioPacketQueue->invalidate(new_serial);
+    if (m_videoFrameQueue) m_videoFrameQueue->invalidate(new_serial);
+    if (m_audioFrameQueue) m_audioFrameQueue->invalidate(new_serial);
+
+    // ʱΪδ֪еĵһ֡У׼
+    if (m_clockManager) {
+        m_clockManager->setClockToUnknown();
+    }
+
+    m_demuxer_eof = false;
+    cout << "MediaPlayer: Seek executed, serial updated to " << new_serial << "." << endl;
+}
+
+void MediaPlayer::switchAudioTrack(int stream_index) {
+    // Ƶ/Ⱦֻ߳ڴʱƵ´
+    if (!m_demuxer || audioStreamIndex.load() < 0 || stream_index < 0) {
+        return;
+    }
+    m_audio_track_request = stream_index;
+    cout << "MediaPlayer: Audio track switch requested to stream " << stream_index << "." << endl;
+
+    // ѿܴڵȴеĽװ߳
+    {
+        std::lock_guard<std::mutex> lock(m_state_mutex);
+    }
+    m_state_cond.notify_all();
+    if (m_packetBuffer) m_packetBuffer->wake();
+}
+
+void MediaPlayer::cycleAudioTrack() {
+    if (!m_demuxer || audioStreamIndex.load() < 0) {
+        return;
+    }
+    std::vector<int> tracks = m_demuxer->getStreamIndices(AVMEDIA_TYPE_AUDIO);
+    if (tracks.size() < 2) {
+        cout << "MediaPlayer: No other audio track to switch to." << endl;
+        return;
+    }
+    // ʱδִеΪ׼
+    int current = m_audio_track_request.load();
+    if (current < 0) {
+        current = audioStreamIndex.load();
+    }
+    auto it = std::find(tracks.begin(), tracks.end(), current);
+    int next = (it == tracks.end() || it + 1 == tracks.end()) ? tracks.front() : *(it + 1);
+    switchAudioTrack(next);
+}
+
+void MediaPlayer::handle_audio_track_request() {
+    int target = m_audio_track_request.exchange(-1);
+    int current = audioStreamIndex.load();
+    if (target < 0 || target == current) {
+        return;
+    }
+    if (!m_demuxer->selectStream(AVMEDIA_TYPE_AUDIO, target)) {
+        cerr << "MediaPlayer: Audio track switch to stream " << target << " failed." << endl;
+        return;
+    }
+
+    // İͬһƵУھѻİ֮󣬽Ųֿյ
+    // Ƶ߳ĵһʱؽкţƵӰ
+    if (m_packetBuffer) {
+        m_packetBuffer->remapStream(current, target);
+    }
+    audioStreamIndex = target;
+
+    if (m_debugStats) {
+        std::vector<int> tracks = m_demuxer->getStreamIndices(AVMEDIA_TYPE_AUDIO);
+        auto it = std::find(tracks.begin(), tracks.end(), target);
+        m_debugStats->audio_track = static_cast<int>(it - tracks.begin()) + 1;
+    }
+    cout << "MediaPlayer: Switched audio track from stream " << current << " to " << target << "." << endl;
+}
+
+void MediaPlayer::toggleRecording() {
+    if (!m_recorder) {
+        cout << "MediaPlayer: Recording is only available for live streams." << endl;
+        return;
+    }
+    m_record_request = m_recorder->isRecording() ? 0 : 1;
+    // װ߳հ (ֱĽװ᳤̲߳ʱȴ)
+}
+
+void MediaPlayer::handle_record_request() {
+    int request = m_record_request.exchange(-1);
+    if (request == 0) {
+        m_recorder->stop();
+    }
+    else if (request == 1 && m_recorder->isFlushing()) {
+        // һ¼д̣ڽװ߳еȴһٴ (ڼ䵽ֹͣ)
+        int none = -1;
+        m_record_request.compare_exchange_strong(none, 1);
+    }
+    else if (request == 1 && !m_recorder->isRecording()) {
+        // ¼ƵǰѡеƵ죻ֶ붪Ƶؼ֡룬ƵʱƵ
+        std::vector<int> streams;
+        if (videoStreamIndex >= 0) streams.push_back(videoStreamIndex);
+        if (audioStreamIndex >= 0) streams.push_back(audioStreamIndex.load());
+        int key_stream = videoStreamIndex >= 0 ? videoStreamIndex : audioStreamIndex.load();
+        if (!m_recorder->start(m_demuxer->getFormatContext(), streams, key_stream)) {
+            cerr << "MediaPlayer: Failed to start recording." << endl;
+        }
+    }
+}
+
+void MediaPlayer::update_live_playback_rate(bool active) {
+    double target_latency = m_low_latency ? LOW_LATENCY_TARGET_SEC : LIVE_TARGET_LATENCY_SEC;
+    double lag = std::nan("");
+    if (m_clockManager && !m_clockManager->isClockUnknown()) {
+        lag = m_live_edge_sec.load() - m_clockManager->getMasterClockTime();
+    }
+
+    // ƣԽԽ࣬岻ʱٻݣڱԭ
+    double target_rate = 1.0;
+    if (active && !std::isnan(lag)) {
+        double error = lag - target_latency;
+        if (std::fabs(error) > CATCH_UP_DEADBAND_SEC) {
+            target_rate = std::max(CATCH_UP_MIN_RATE, std::min(CATCH_UP_MAX_RATE, 1.0 + error * CATCH_UP_GAIN));
+        }
+    }
+    //  0.01ÿڵı仯Ƶ
+    target_rate = std::round(target_rate * 100.0) / 100.0;
+    double rate = m_playback_rate;
+    if (target_rate > rate) {
+        rate = std::min(target_rate, rate + CATCH_UP_RATE_STEP);
+    }
+    else if (target_rate < rate) {
+        rate = std::max(target_rate, rate - CATCH_UP_RATE_STEP);
+    }
+
+    if (rate != m_playback_rate) {
+        m_playback_rate = rate;
+        // ʱƵͬʱ٣ƵʱٺʱƵʱԣ趪֡
+        if (m_clockManager) m_clockManager->setPlaybackRate(rate);
+        if (m_audioRenderer) m_audioRenderer->setPlaybackRate(rate);
+    }
+
+    if (m_debugStats) {
+        m_debugStats->live_lag_ms = std::isnan(lag) ? -1.0 : std::max(0.0, lag * 1000.0);
+        m_debugStats->live_target_ms = target_latency * 1000.0;
+        m_debugStats->playback_rate = m_playback_rate;
+    }
+}
+
+void MediaPlayer::record_live_latency(const AVFrame* frame) {
+    if (!m_debugStats || !frame) return;
+
+    // ָƽֵ浥֡
+    auto smooth = [](std::atomic<double>& value, double sample) {
+        double prev = value.load();
+        value = prev < 0.0 ? sample : prev + (sample - prev) * 0.1;
+    };
+
+    // հʾװ߳ڰϼ¼հʱ̾ݵ֡
+    Uint32 arrival_ms = static_cast<Uint32>(reinterpret_cast<uintptr_t>(frame->opaque));
+    if (arrival_ms != 0) {
+        smooth(m_debugStats->live_recv_latency_ms, static_cast<double>(SDL_GetTicks() - arrival_ms));
+    }
+
+    // ɼʾ (glass-to-glass)Ҫṩ pts ӦľԲɼʱ̣뱾ʱӾ NTP ͬ
+    int64_t origin_us = m_live_realtime_origin_us.load();
+    if (origin_us != AV_NOPTS_VALUE && frame->pts != AV_NOPTS_VALUE) {
+        int64_t capture_us = origin_us + av_rescale_q(frame->pts, m_videoDecoder->getTimeBase(), AVRational{ 1, AV_TIME_BASE });
+        smooth(m_debugStats->live_glass_latency_ms, (av_gettime() - capture_us) / 1000.0);
+    }
+}
+
 void MediaPlayer::cleanup_ffmpeg_resources() {
     cout << "MediaPlayer: Cleaning up FFmpeg resources..." << endl;
 
@@ -568,14 +1012,15 @@ void MediaPlayer::cleanup_ffmpeg_resources() {
         // av_frame_free Զִн unref 
         av_packet_free(&m_decodingVideoPacket);
     }
-    if (m_renderingVideoFrame) {
-        av_frame_free(&m_renderingVideoFrame);
-    }
-    if (m_decodingAudioPacket) {
-        av_packet_free(&m_decodingAudioPacket);
+    for (AVPacket*& pkt : m_decodingAudioPackets) {
+        if (pkt) {
+            av_packet_free(&pkt);
+        }
     }
-    if (m_renderingAudioFrame) {
-        av_frame_free(&m_renderingAudioFrame);
+    for (AVFrame*& frame : m_renderingAudioFrames) {
+        if (frame) {
+            av_frame_free(&frame);
+        }
     }
 
     cout << "MediaPlayer: FFmpeg resources cleanup finished." << endl;
@@ -589,6 +1034,7 @@ void MediaPlayer::cleanup() {
     m_state_cond.notify_all();
     
     // ڵȴ߳ǰȴп/µpush/pop
+    if (m_packetBuffer) m_packetBuffer->abort();
     if (m_videoPacketQueue) m_videoPacketQueue->abort();
     if (m_audioPacketQueue) m_audioPacketQueue->abort();
     if (m_videoFrameQueue) m_videoFrameQueue->abort();
@@ -670,7 +1116,20 @@ void MediaPlayer::cleanup() {
     // ͷFFmpegԴ
     cleanup_ffmpeg_resources();
 
-    // ͷŶкʱ
+    // ͷŶкʱ (·ֻжָ룬ڶͷ)
+    if (m_packetBuffer) {
+        m_packetBuffer.reset();
+        cout << "MediaPlayer: Interleaved packet buffer cleaned up." << endl;
+    }
+    if (m_timeshift) {
+        m_timeshift.reset();
+        cout << "MediaPlayer: Timeshift buffer cleaned up." << endl;
+    }
+    if (m_recorder) {
+        // ʱȴд߳дŶӵݲرļ
+        m_recorder.reset();
+        cout << "MediaPlayer: Stream recorder cleaned up." << endl;
+    }
     if (m_videoPacketQueue) {
         m_videoPacketQueue.reset();
         cout << "MediaPlayer: Video packet queue cleaned up." << endl;
@@ -715,6 +1174,10 @@ int MediaPlayer::demux_thread_func() {
     int read_ret = 0;
     bool isLive = m_demuxer && m_demuxer->isLiveStream();
 
+    // ֱ GOP ҪƵüͬһʱ㣬Ԥȡ·ʱ
+    AVRational video_tb = videoStreamIndex >= 0 ? m_demuxer->getTimeBase(videoStreamIndex) : AVRational{ 0, 1 };
+    AVRational audio_tb = audioStreamIndex >= 0 ? m_demuxer->getTimeBase(audioStreamIndex) : AVRational{ 0, 1 };
+
     while (!m_quit) {
         // ȡǰ״̬
         PlayerState currentState = m_playerState.load();
@@ -724,30 +1187,49 @@ int MediaPlayer::demux_thread_func() {
                 // ֱ-ͣԡ
                 // Ϊ˷ֹ TCP  ͷ
                 // ͣʱȡݣֱӶ
+                // ʱʱΪ¼ʱƻ壺ŶָͣͣͰͣҲԻؿ
+                // ¼ͬͣӰ
+                if (m_timeshift) {
+                    set_timeshifted(true);
+                    if (m_seek_pending.load()) {
+                        handle_seek_request();
+                        continue;
+                    }
+                }
+                if (m_record_request.load() >= 0) {
+                    handle_record_request();
+                }
 
                 read_ret = m_demuxer->readPacket(demux_packet);
                 if (read_ret >= 0) {
-                    // ȡɹֱͷã
+                    ingest_live_packet(demux_packet, video_tb, audio_tb);
+                    // ͷű (δʱʱΪ)
                     av_packet_unref(demux_packet);
                 }
                 else {
                     // ȡ ( EOF  Ķ)
                     if (read_ret != AVERROR(EAGAIN)) {
-                        // ¼󵫸Ƿ˳
-                        // 򵥴ӡ棬شںѭбо˳
+                        // ͣͬʱֻӡ棬ָźĶٴγԭ˳
                         cerr << "Warning: Live stream read error during pause." << endl;
+                        if (reconnect_live_stream(video_tb, audio_tb)) {
+                            continue;
+                        }
                     }
                 }
 
                 // ʱѭռһ CPU 
-                SDL_Delay(10);
+                // (¼ʱʱ readPacket 絽ʱ¼Ƹ)
+                if (read_ret < 0 || !m_timeshift) {
+                    SDL_Delay(10);
+                }
                 continue; // ߼ֱӽһѭ
             }
             else {
                 // ļ-ͣԡ
                 std::unique_lock<std::mutex> lock(m_state_mutex);
                 m_state_cond.wait(lock, [this] {
-                    return m_playerState != PlayerState::PAUSED || m_quit;
+                    return m_playerState != PlayerState::PAUSED || m_quit || m_seek_pending ||
+                        m_audio_track_request.load() >= 0;
                     });
             }
         }
@@ -755,15 +1237,50 @@ int MediaPlayer::demux_thread_func() {
         // ˳ѣֱ˳ѭ
         if (m_quit) break;
 
+        // ִйתȻ¼״̬ (ͣеתִкȴ)
+        if (m_seek_pending.load()) {
+            handle_seek_request();
+            continue;
+        }
+        if (m_audio_track_request.load() >= 0) {
+            handle_audio_track_request();
+            audio_tb = audioStreamIndex >= 0 ? m_demuxer->getTimeBase(audioStreamIndex) : AVRational{ 0, 1 };
+            continue;
+        }
+        if (m_record_request.load() >= 0) {
+            handle_record_request();
+        }
+
+        // ļлѻ㹻ʱͣȡֻҪһ·žͼ
+        // Ӳһ·Ԥ⽻֯ļƵ
+        if (m_packetBuffer && m_packetBuffer->isEnough()) {
+            m_packetBuffer->waitWhileEnough(10);
+            continue; // ¼״̬˳־
+        }
+
         read_ret = m_demuxer->readPacket(demux_packet);
 
         // 
         if (read_ret < 0) {
+            // ʵʱ (˽µ EOFʱ)ȳɹȡ
+            if (isLive && read_ret != AVERROR(EAGAIN) && reconnect_live_stream(video_tb, audio_tb)) {
+                continue;
+            }
             if (read_ret == AVERROR_EOF) {
-                cout << "MediaPlayer DemuxThread: Demuxer reached EOF." << endl;
-                m_demuxer_eof = true;
-                if (m_videoPacketQueue) { m_videoPacketQueue->signal_eof(); }
-                if (m_audioPacketQueue) { m_audioPacketQueue->signal_eof(); }
+                if (!m_demuxer_eof.load()) {
+                    cout << "MediaPlayer DemuxThread: Demuxer reached EOF." << endl;
+                    m_demuxer_eof = true;
+                    if (m_videoPacketQueue) { m_videoPacketQueue->signal_eof(); }
+                    if (m_audioPacketQueue) { m_audioPacketQueue->signal_eof(); }
+                }
+                if (!isLive) {
+                    // ļִ̱߳Աʣݲ֮ǰӦת
+                    std::unique_lock<std::mutex> lock(m_state_mutex);
+                    m_state_cond.wait_for(lock, std::chrono::milliseconds(20), [this] {
+                        return m_quit.load() || m_seek_pending.load() || m_audio_track_request.load() >= 0;
+                        });
+                    continue;
+                }
             }
             else {
                 char errbuf[AV_ERROR_MAX_STRING_SIZE];
@@ -776,54 +1293,17 @@ int MediaPlayer::demux_thread_func() {
             break; // ˳⸴ѭ
         }
 
-        if (m_wait_for_keyframe) {
-            // ָͣѰҵһƵؼ֡
+        bool buffered = isLive && ingest_live_packet(demux_packet, video_tb, audio_tb);
 
-            // 1. Ƶ
-            if (demux_packet->stream_index == videoStreamIndex) {
-                // ǷΪؼ֡ (IDR)
-                if (is_idr_frame(demux_packet, m_videoDecoder->getCodecID())) {
-                    cout << "MediaPlayer DemuxerThread: Video IDR found! Aligning streams and starting playback." << endl;
-                    m_wait_for_keyframe = false;
-                    // ߣ
-                }
-                else {
-                    // ǹؼ֡
-                    av_packet_unref(demux_packet);
-                    continue;
-                }
-            }
-            // 2. Ƶ
-            else if (audioStreamIndex >= 0 && demux_packet->stream_index == audioStreamIndex) {
-                // ҵƵؼ֮֡ǰƵҲ붪
-                // ƵܣƵȾΪƵͺǰȴͶ
-                av_packet_unref(demux_packet);
-                continue;
-            }
-            // 3. ֱӶ
-            else {
-                av_packet_unref(demux_packet);
-                continue;
-            }
+        // ʱƻ (Ψһ GOP ֽ) α׷ʱ·ֱӷֱַӰ
+        if (m_timeshift && (buffered || m_timeshift->hasPending())) {
+            // ¼ʱƻ (뻺干)ŶдӻĶαȡֱԵʱΪյ
+            av_packet_unref(demux_packet);
+            feed_from_timeshift(demux_packet, isLive, video_tb, audio_tb);
         }
-
-        // ȡǰµк
-        int current_serial = m_seek_serial.load();
-
-        // ַ߼
-        if (demux_packet->stream_index == videoStreamIndex) {
-            if (m_videoPacketQueue) {
-                m_videoPacketQueue->push(demux_packet, current_serial);
-            }
-        }
-        else if (audioStreamIndex >= 0 && demux_packet->stream_index == audioStreamIndex) {
-            if (m_audioPacketQueue) {
-                m_audioPacketQueue->push(demux_packet, current_serial);
-            }
+        else {
+            dispatch_packet(demux_packet, isLive, video_tb, audio_tb);
         }
-
-        // PacketQueue::push  av_packet_refȡԭʼҪ unref
-        av_packet_unref(demux_packet);
     }
 
     av_packet_free(&demux_packet); // ͷűذ
@@ -841,6 +1321,200 @@ int MediaPlayer::demux_thread_func() {
     return 0;
 }
 
+void MediaPlayer::dispatch_packet(AVPacket* packet, bool isLive, const AVRational& video_tb, const AVRational& audio_tb) {
+    if (m_wait_for_keyframe) {
+        // ָͣѰҵһƵؼ֡
+
+        // 1. Ƶ
+        if (packet->stream_index == videoStreamIndex) {
+            // ǷΪؼ֡ (IDR)
+            if (is_idr_frame(packet, m_videoDecoder->getCodecID())) {
+                cout << "MediaPlayer DemuxerThread: Video IDR found! Aligning streams and starting playback." << endl;
+                m_wait_for_keyframe = false;
+                // ߣ
+            }
+            else {
+                // ǹؼ֡
+                av_packet_unref(packet);
+                return;
+            }
+        }
+        // 2. Ƶ
+        else if (audioStreamIndex >= 0 && packet->stream_index == audioStreamIndex) {
+            // ҵƵؼ֮֡ǰƵҲ붪
+            // ƵܣƵȾΪƵͺǰȴͶ
+            av_packet_unref(packet);
+            return;
+        }
+        // 3. ֱӶ
+        else {
+            av_packet_unref(packet);
+            return;
+        }
+    }
+
+    // ȡǰµк
+    int current_serial = m_seek_serial.load();
+
+    // ַ߼ƽʽӣ
+    if (m_packetBuffer) {
+        // ļɶ·尴ַӦ
+        m_packetBuffer->push(std::move(packet), current_serial);
+    }
+    else if (packet->stream_index == videoStreamIndex) {
+        if (m_videoPacketQueue) {
+            m_videoPacketQueue->push(std::move(packet), current_serial);
+
+            // Ƶж GOPƵҲ GOP 㣬Ƶǰ
+            int64_t resume_pts = AV_NOPTS_VALUE;
+            if (isLive && m_videoPacketQueue->takeGopDropEvent(resume_pts)) {
+                if (m_audioPacketQueue && video_tb.den != 0 && audio_tb.den != 0) {
+                    m_audioPacketQueue->dropBefore(av_rescale_q(resume_pts, video_tb, audio_tb));
+                }
+                if (m_debugStats) {
+                    m_debugStats->vq_gop_drops++;
+                }
+            }
+        }
+    }
+    else if (audioStreamIndex >= 0 && packet->stream_index == audioStreamIndex) {
+        // Ƶڵȴһؼ֡µƵ뱻ƵͬһΣһ
+        bool video_skipping = isLive && m_videoPacketQueue && m_videoPacketQueue->isSkippingToKeyframe();
+        if (m_audioPacketQueue && !video_skipping) {
+            m_audioPacketQueue->push(std::move(packet), current_serial);
+        }
+    }
+
+    // ɹӺ packet ǿհֻͷδӣʧܻ򱻶
+    av_packet_unref(packet);
+
+    if (isLive && m_debugStats) {
+        if (m_videoPacketQueue) {
+            m_debugStats->vq_dropped_pkts = m_videoPacketQueue->getDroppedPackets();
+        }
+        if (m_audioPacketQueue) {
+            m_debugStats->aq_dropped_pkts = m_audioPacketQueue->getDroppedPackets();
+        }
+    }
+}
+
+bool MediaPlayer::ingest_live_packet(AVPacket* packet, const AVRational& video_tb, const AVRational& audio_tb) {
+    // ¼հʱ̣ݵ֡ڲհʾӳ (0 Ϊδ¼)
+    Uint32 arrival_ms = SDL_GetTicks();
+    packet->opaque = reinterpret_cast<void*>(static_cast<uintptr_t>(arrival_ms ? arrival_ms : 1));
+    // յݵʱֱġԵ׷֡벥λ֮Ϊӳ
+    int edge_stream = videoStreamIndex >= 0 ? videoStreamIndex : audioStreamIndex.load();
+    int64_t edge_ts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+    if (packet->stream_index == edge_stream && edge_ts != AV_NOPTS_VALUE) {
+        m_live_edge_sec = edge_ts * av_q2d(edge_stream == videoStreamIndex ? video_tb : audio_tb);
+    }
+    // RTSP յ RTCP SR ܵõ pts=0 ӦĲɼʱ
+    AVFormatContext* fmt_ctx = m_demuxer->getFormatContext();
+    if (fmt_ctx && fmt_ctx->start_time_realtime != AV_NOPTS_VALUE) {
+        m_live_realtime_origin_us = fmt_ctx->start_time_realtime;
+    }
+
+    bool recording = m_recorder && m_recorder->isRecording();
+    if (!m_timeshift && !recording) return false;
+
+    // ַֻڲŵ·Ƶ IDR Ϊ/ֶ㣬ƵÿΪ
+    bool is_video = packet->stream_index == videoStreamIndex;
+    bool is_audio = !is_video && audioStreamIndex >= 0 && packet->stream_index == audioStreamIndex;
+    if (!is_video && !is_audio) return false;
+    bool keyframe = is_video ? is_idr_frame(packet, m_videoDecoder->getCodecID()) : videoStreamIndex < 0;
+
+    // ¼ƣֻü¼ƶУӲ
+    if (recording) {
+        m_recorder->submit(packet, keyframe);
+    }
+
+    if (!m_timeshift) return false;
+
+    int64_t ts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+    double time_sec = ts != AV_NOPTS_VALUE ? ts * av_q2d(is_video ? video_tb : audio_tb) : std::nan("");
+    bool buffered = m_timeshift->append(packet, time_sec, keyframe);
+
+    if (m_timeshift->takeOverrun()) {
+        // ͣؿ̫ãԽλãӴɵĹؼ֡ʼµĲ
+        cout << "MediaPlayer: Timeshift window overran the playback position, restarting from the oldest keyframe." << endl;
+        begin_seek_serial(m_timeshift->getStartTime(), SeekMode::KEYFRAME, SDL_GetPerformanceCounter());
+    }
+
+    if (m_debugStats) {
+        m_debugStats->timeshift_window_sec = m_timeshift->getDuration();
+        m_debugStats->timeshift_mb = m_timeshift->getBytes() / (1024.0 * 1024.0);
+    }
+    return buffered;
+}
+
+void MediaPlayer::feed_from_timeshift(AVPacket* packet, bool isLive, const AVRational& video_tb, const AVRational& audio_tb) {
+    while (m_timeshift->hasPending()) {
+        if (m_timeshifted.load()) {
+            // 뿪ֱԵͰлж㹻ʱͣ£ʱƻ
+            bool video_enough = !m_videoPacketQueue || m_videoPacketQueue->hasEnoughPackets();
+            bool audio_enough = !m_audioPacketQueue || m_audioPacketQueue->hasEnoughPackets();
+            if (video_enough && audio_enough) {
+                break;
+            }
+        }
+        if (!m_timeshift->read(packet)) {
+            break;
+        }
+        dispatch_packet(packet, isLive, video_tb, audio_tb);
+    }
+}
+
+void MediaPlayer::set_timeshifted(bool timeshifted) {
+    if (m_timeshifted.exchange(timeshifted) == timeshifted) {
+        return;
+    }
+    // 뿪ֱԵ󣬶еʱ/ֽԤֻжϡ㹻ٰ GOP  (ݶʱƻ)
+    // صֱָԣ׷֡ GOP ӳ
+    if (m_videoPacketQueue) m_videoPacketQueue->setSoftBudget(timeshifted);
+    if (m_audioPacketQueue) m_audioPacketQueue->setSoftBudget(timeshifted);
+    if (m_debugStats) {
+        m_debugStats->timeshifted = timeshifted;
+    }
+    cout << "MediaPlayer: " << (timeshifted ? "Left the live edge, playing from the timeshift buffer." : "Back at the live edge.") << endl;
+}
+
+bool MediaPlayer::reconnect_live_stream(AVRational& video_tb, AVRational& audio_tb) {
+    if (!LIVE_RECONNECT || m_quit.load()) {
+        return false;
+    }
+
+    IDemuxer::ReconnectResult result = m_demuxer->reconnect(LIVE_RECONNECT_MAX_ATTEMPTS);
+    if (result == IDemuxer::ReconnectResult::FAILED) {
+        return false;
+    }
+    if (result == IDemuxer::ReconnectResult::STREAMS_CHANGED) {
+        // Ⱦزɲﲻؽ
+        // رӣ֮Ķ²İ͸ɵĽ
+        cerr << "MediaPlayer DemuxThread: Stream parameters changed after reconnecting, stopping playback." << endl;
+        m_demuxer->close();
+        return false;
+    }
+
+    // ӵİ֡ȫʧЧӵĵһؼ֡ʼкʱˢ
+    resync_after_pause();
+    // ӵʱܴͷʼʱƻеݲ
+    if (m_timeshift) {
+        m_timeshift->clear();
+        set_timeshifted(false);
+    }
+    if (m_recorder) {
+        m_recorder->markDiscontinuity();
+    }
+    m_live_edge_sec = std::nan("");
+    m_live_realtime_origin_us = AV_NOPTS_VALUE;
+
+    // кľɿ߳̽ BUFFERINGݻָܹ
+    video_tb = videoStreamIndex >= 0 ? m_demuxer->getTimeBase(videoStreamIndex) : AVRational{ 0, 1 };
+    audio_tb = audioStreamIndex >= 0 ? m_demuxer->getTimeBase(audioStreamIndex) : AVRational{ 0, 1 };
+    cout << "MediaPlayer DemuxThread: Live stream recovered, waiting for the next keyframe." << endl;
+    return true;
+}
+
 // Ƶ߳ں
 int MediaPlayer::video_decode_thread_entry(void* opaque) {
     return static_cast<MediaPlayer*>(opaque)->video_decode_func();
@@ -918,6 +1592,10 @@ int MediaPlayer::video_decode_func() {
 
     AVFrame* decoded_frame = nullptr;
     int pkt_serial = 0; // к
+    int decoder_serial = m_seek_serial.load();      // ǰڲ״̬
+    AVDiscard current_skip = AVDISCARD_DEFAULT;      // ǰõ֡
+    AVDiscard current_loop_filter = AVDISCARD_DEFAULT; // ǰõĻ·˲
+    AVRational video_tb = m_videoDecoder->getTimeBase();
 
     while (!m_quit) {
         // ״̬ȴ߼
@@ -935,36 +1613,39 @@ int MediaPlayer::video_decode_func() {
         if (!m_videoPacketQueue->pop(m_decodingVideoPacket, pkt_serial, -1)) {
             //  EOFϴ
             if (m_videoPacketQueue->is_eof()) {
+                int eof_serial = m_seek_serial.load();
                 cout << "MediaPlayer VideoDecodeThread: Packet queue EOF, starting to flush decoder." << endl;
-                int flush_ret = m_videoDecoder->decode(nullptr, &decoded_frame); //  nullptr ϴ
-                while (flush_ret == 0) {
-                    if (decoded_frame) {
-                        if (!m_videoFrameQueue->push(decoded_frame)) {
-                            if (m_quit.load()) {
-                                cout << "MediaPlayer VideoDecodeThread: Discarding flushed frame as shutdown is in progress." << endl;
-                            }
-                            else {
-                                cerr << "MediaPlayer VideoDecodeThread: Failed to push flushed frame to frame queue." << endl;
-                            }
-                            // ζҪͷ frame
-                            av_frame_free(&decoded_frame);
-                            // ζ/ֹ޷ͣӦжϳϴ
-                            break;
+                //  nullptr ϴȡʣȫ֡
+                int flush_ret = m_videoDecoder->decodeAll(nullptr, &decoded_frame, [&](AVFrame* frame) {
+                    if (!m_videoFrameQueue->push(std::move(frame), pkt_serial)) {
+                        if (m_quit.load()) {
+                            cout << "MediaPlayer VideoDecodeThread: Discarding flushed frame as shutdown is in progress." << endl;
+                        }
+                        else {
+                            cerr << "MediaPlayer VideoDecodeThread: Failed to push flushed frame to frame queue." << endl;
                         }
-                        av_frame_free(&decoded_frame);
+                        // ζҪͷ frame е
+                        av_frame_unref(frame);
+                        // ζ/ֹ޷ͣӦжϳϴ
+                        return false;
                     }
-                    flush_ret = m_videoDecoder->decode(nullptr, &decoded_frame); // Իȡ
-                }
+                    return true;
+                    });
                 if (flush_ret == AVERROR_EOF) {
                     cout << "MediaPlayer VideoDecodeThread: Video decoder fully flushed." << endl;
                 }
-                else if (flush_ret != AVERROR(EAGAIN)) {
+                else if (flush_ret != AVERROR_EXIT) {
                     char errbuf[AV_ERROR_MAX_STRING_SIZE];
                     av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, flush_ret);
                     cerr << "MediaPlayer VideoDecodeThread: Error flushing decoder: " << errbuf << endl;
                 }
                 m_videoFrameQueue->signal_eof();
-                break;
+
+                // װ߳ EOF ӦתִȴµĲУ
+                // ϴĽ EOF ״̬һʱ flush
+                wait_for_new_serial(m_videoPacketQueue.get(), eof_serial);
+                decoder_serial = -1;
+                continue;
             }
             else {
                 // abort()ֱ˳
@@ -980,11 +1661,49 @@ int MediaPlayer::video_decode_func() {
             av_packet_unref(m_decodingVideoPacket);
             continue; // ֱӽһѭ
         }
+
+        // еĵһսڲľ (ڱִ߳У벢)
+        if (pkt_serial != decoder_serial) {
+            m_videoDecoder->flush();
+            decoder_serial = pkt_serial;
+        }
+
+        // ȷתĿ֮ǰķǲο֡ᱻʾҲ֡οֱ
+        bool accurate_seek = (pkt_serial == m_accurate_seek_serial.load());
+        double seek_target = m_accurate_seek_target.load();
+        AVDiscard skip = AVDISCARD_DEFAULT;
+        if (accurate_seek && m_decodingVideoPacket->pts != AV_NOPTS_VALUE &&
+            m_decodingVideoPacket->pts * av_q2d(video_tb) < seek_target) {
+            skip = AVDISCARD_NONREF;
+        }
+        // Ⱦٵ֡ĵȼڽǰעʾĹ (AVDiscard ֵȡǿ)
+        AVDiscard loop_filter = AVDISCARD_DEFAULT;
+        if (m_frameSkip) {
+            int level = m_frameSkip->getLevel();
+            skip = std::max(skip, FrameSkipController::skipFrameFor(level));
+            loop_filter = FrameSkipController::skipLoopFilterFor(level);
+        }
+        if (skip != current_skip) {
+            m_videoDecoder->setSkipFrame(skip);
+            current_skip = skip;
+        }
+        if (loop_filter != current_loop_filter) {
+            m_videoDecoder->setSkipLoopFilter(loop_filter);
+            current_loop_filter = loop_filter;
+        }
         
-        int decode_ret = m_videoDecoder->decode(m_decodingVideoPacket, &decoded_frame);
-        av_packet_unref(m_decodingVideoPacket);
+        // һȡʱȫ֡ (֡߳ʱһܴ֡)
+        int decode_ret = m_videoDecoder->decodeAll(m_decodingVideoPacket, &decoded_frame, [&](AVFrame* frame) {
+            // ȷתʾĿֱ֡Ӷ
+            if (accurate_seek && frame->pts != AV_NOPTS_VALUE) {
+                double frame_pts = frame->pts * av_q2d(video_tb);
+                double frame_dur = frame->duration > 0 ? frame->duration * av_q2d(video_tb) : 0.0;
+                if (frame_dur > 0.0 ? (frame_pts + frame_dur <= seek_target) : (frame_pts < seek_target)) {
+                    av_frame_unref(frame);
+                    return true;
+                }
+            }
 
-        if (decode_ret == 0 && decoded_frame) {
             // ͳϢ-½֡
             if (m_debugStats) {
                 m_debugStats->decode_fps.tick();
@@ -1000,7 +1719,8 @@ int MediaPlayer::video_decode_func() {
                 }
             }
 
-            if (!m_videoFrameQueue->push(decoded_frame)) {
+            // ƽʽӣframe Ϊ֡һȡ֡ʱ
+            if (!m_videoFrameQueue->push(std::move(frame), pkt_serial)) {
                 // ǲΪ˳
                 if (m_quit.load()) {
                     cout << "MediaPlayer VideoDecodeThread: Discarding frame as shutdown is in progress." << endl;
@@ -1008,11 +1728,15 @@ int MediaPlayer::video_decode_func() {
                 else {
                     cerr << "MediaPlayer VideoDecodeThread: Failed to push decoded frame to frame queue." << endl;
                 }
+                av_frame_unref(frame);
+                return false;
             }
-            av_frame_free(&decoded_frame);
-        }
-        else if (decode_ret == AVERROR(EAGAIN)) {
-            // ѭԷһ֡
+            return true;
+            });
+        av_packet_unref(m_decodingVideoPacket);
+
+        if (decode_ret == 0 || decode_ret == AVERROR_EXIT) {
+            // ȡգֹ֡ (˳/)ѭ
         }
         else if (decode_ret == AVERROR_EOF) {
             cout << "MediaPlayer VideoDecodeThread: Decoder signaled EOF during decoding." << endl;
@@ -1034,6 +1758,9 @@ int MediaPlayer::video_decode_func() {
         m_videoFrameQueue->signal_eof();
     }
 
+    // ͷ߳ڸõĽ֡
+    av_frame_free(&decoded_frame);
+
     return 0;
 }
 
@@ -1053,6 +1780,19 @@ int MediaPlayer::audio_decode_func() {
     AVFrame* decoded_frame = nullptr;
     int pkt_serial = 0;
 
+    int decoder_serial = m_seek_serial.load(); // ǰڲ״̬
+    int decoder_stream = audioStreamIndex.load(); // ǰӦƵ
+    bool decoder_ready = true;
+    // ȾʱӰʱ PTSлʱͬ󣬽 PTS ظʱ
+    AVRational audio_tb = m_audioDecoder->getTimeBase();
+    AVRational decoder_tb = audio_tb;
+    int sample_rate = m_audioDecoder->getSampleRate();
+
+    // ǰеİк
+    int batch_serials[AUDIO_DECODE_BATCH] = {};
+    size_t batch_count = 0;
+    size_t batch_pos = 0;
+
     while (!m_quit) {
         // ״̬ȴ߼
         {
@@ -1063,44 +1803,52 @@ int MediaPlayer::audio_decode_func() {
         }
         if (m_quit) break;
 
-        // 1. Ƶȡһ
-        if (!m_audioPacketQueue->pop(m_decodingAudioPacket, pkt_serial, -1)) {
+        // 1. ǰѴʱƵȡһ
+        if (batch_pos >= batch_count) {
+            batch_count = m_audioPacketQueue->pop_batch(m_decodingAudioPackets, batch_serials, AUDIO_DECODE_BATCH, -1);
+            batch_pos = 0;
+        }
+        if (batch_count == 0) {
             //  EOF
             if (m_audioPacketQueue->is_eof()) {
+                int eof_serial = m_seek_serial.load();
                 cout << "MediaPlayer AudioDecodeThread: Packet queue EOF, starting to flush decoder." << endl;
 
-                //  nullptr ˢ½
-                int flush_ret = m_audioDecoder->decode(nullptr, &decoded_frame);
-                while (flush_ret == 0) { // ȡֱ֡޸
-                    if (decoded_frame) {
-                        if (!m_audioFrameQueue->push(decoded_frame)) {
-                            if (m_quit.load()) {
-                                cout << "MediaPlayer AudioDecodeThread: Discarding flushed frame as shutdown is in progress." << endl;
-                            }
-                            else {
-                                cerr << "MediaPlayer AudioDecodeThread: Failed to push flushed frame to frame queue." << endl;
-                            }
-                            // ʼͷ frame
-                            av_frame_free(&decoded_frame);
-                            // ζ/ֹ޷ͣжϳϴ
-                            break;
+                //  nullptr ˢ½ (лʼʧʱûпɳϴ)
+                int flush_ret = !decoder_ready ? AVERROR_EOF :
+                    m_audioDecoder->decodeAll(nullptr, &decoded_frame, [&](AVFrame* frame) { // ȡʣȫ֡
+                    if (frame->pts != AV_NOPTS_VALUE && av_cmp_q(decoder_tb, audio_tb) != 0) {
+                        frame->pts = av_rescale_q(frame->pts, decoder_tb, audio_tb);
+                    }
+                    if (!m_audioFrameQueue->push(std::move(frame), pkt_serial)) {
+                        if (m_quit.load()) {
+                            cout << "MediaPlayer AudioDecodeThread: Discarding flushed frame as shutdown is in progress." << endl;
+                        }
+                        else {
+                            cerr << "MediaPlayer AudioDecodeThread: Failed to push flushed frame to frame queue." << endl;
                         }
-                        av_frame_free(&decoded_frame);
+                        // ʼͷ frame е
+                        av_frame_unref(frame);
+                        // ζ/ֹ޷ͣжϳϴ
+                        return false;
                     }
-                    // Իȡһϴ֡
-                    flush_ret = m_audioDecoder->decode(nullptr, &decoded_frame);
-                }
+                    return true;
+                    });
                 if (flush_ret == AVERROR_EOF) {
                     cout << "MediaPlayer AudioDecodeThread: Audio decoder fully flushed." << endl;
                 }
-                else if (flush_ret != AVERROR(EAGAIN)) {
+                else if (flush_ret != AVERROR_EXIT) {
                     char errbuf[AV_ERROR_MAX_STRING_SIZE];
                     av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, flush_ret);
                     cerr << "MediaPlayer AudioDecodeThread: Error flushing audio decoder: " << errbuf << endl;
                 }
 
                 m_audioFrameQueue->signal_eof(); // Ƶ֡зEOFź
-                break; // ˳ѭ
+
+                // Ƶ߳ͬȴתʼµĲУ֮ĵһ flush 
+                wait_for_new_serial(m_audioPacketQueue.get(), eof_serial);
+                decoder_serial = -1;
+                continue;
             }
             else {
                 cout << "MediaPlayer AudioDecodeThread: Packet queue aborted, exiting loop." << endl;
@@ -1108,19 +1856,70 @@ int MediaPlayer::audio_decode_func() {
             break; // ˳ѭ
         }
 
+        AVPacket* packet = m_decodingAudioPackets[batch_pos];
+        pkt_serial = batch_serials[batch_pos];
+        batch_pos++;
+
         // кż
         if (pkt_serial != m_seek_serial.load()) {
             // ɰ
-            av_packet_unref(m_decodingAudioPacket);
+            av_packet_unref(packet);
+            continue;
+        }
+
+        // лѻİճ룻ǰĵһʱؽ
+        // ˺Բİ (лʱ) ֱӶ
+        if (packet->stream_index != decoder_stream) {
+            int current_stream = audioStreamIndex.load();
+            if (packet->stream_index != current_stream) {
+                av_packet_unref(packet);
+                continue;
+            }
+            AVCodecParameters* params = m_demuxer->getCodecParameters(current_stream);
+            AVRational stream_tb = m_demuxer->getTimeBase(current_stream);
+            m_audioDecoder->close();
+            decoder_ready = params && m_audioDecoder->init(params, stream_tb, m_clockManager.get());
+            if (decoder_ready) {
+                decoder_tb = m_audioDecoder->getTimeBase();
+                sample_rate = m_audioDecoder->getSampleRate();
+                cout << "MediaPlayer AudioDecodeThread: Decoder reinitialized for audio stream " << current_stream << "." << endl;
+            }
+            else {
+                cerr << "MediaPlayer AudioDecodeThread: Failed to initialize decoder for audio stream "
+                    << current_stream << ", dropping its packets." << endl;
+            }
+            decoder_stream = current_stream;
+            decoder_serial = pkt_serial;
+        }
+        if (!decoder_ready) {
+            av_packet_unref(packet);
             continue;
         }
 
-        // 2. ݰ
-        int decode_ret = m_audioDecoder->decode(m_decodingAudioPacket, &decoded_frame);
-        av_packet_unref(m_decodingAudioPacket); // Ҫݰ
+        // еĵһսڲľ
+        if (pkt_serial != decoder_serial) {
+            m_audioDecoder->flush();
+            decoder_serial = pkt_serial;
+        }
+
+        // 2. ݰȡȫ֡ (һܺƵ֡)
+        bool accurate_seek = (pkt_serial == m_accurate_seek_serial.load());
+        int decode_ret = m_audioDecoder->decodeAll(packet, &decoded_frame, [&](AVFrame* frame) {
+            if (frame->pts != AV_NOPTS_VALUE && av_cmp_q(decoder_tb, audio_tb) != 0) {
+                frame->pts = av_rescale_q(frame->pts, decoder_tb, audio_tb);
+            }
+
+            // ȷתĿ֮ǰѲƵ֡
+            if (accurate_seek && frame->pts != AV_NOPTS_VALUE && sample_rate > 0) {
+                double frame_end = frame->pts * av_q2d(audio_tb) + static_cast<double>(frame->nb_samples) / sample_rate;
+                if (frame_end <= m_accurate_seek_target.load()) {
+                    av_frame_unref(frame);
+                    return true;
+                }
+            }
 
-        if (decode_ret == 0 && decoded_frame) {
-            if (!m_audioFrameQueue->push(decoded_frame)) {
+            // ƽʽӣframe Ϊ֡һȡ֡ʱ
+            if (!m_audioFrameQueue->push(std::move(frame), pkt_serial)) {
                 // ǲΪ˳
                 if (m_quit.load()) {
                     cout << "MediaPlayer AudioDecodeThread: Discarding frame as shutdown is in progress." << endl;
@@ -1128,11 +1927,15 @@ int MediaPlayer::audio_decode_func() {
                 else {
                     cerr << "MediaPlayer AudioDecodeThread: Failed to push decoded frame to frame queue." << endl;
                 }
+                av_frame_unref(frame);
+                return false;
             }
-            av_frame_free(&decoded_frame);
-        }
-        else if (decode_ret == AVERROR(EAGAIN)) {
-            // Ҫ룬ѭԻȡһ
+            return true;
+            });
+        av_packet_unref(packet); // Ҫݰ
+
+        if (decode_ret == 0 || decode_ret == AVERROR_EXIT) {
+            // ȡգֹ֡ѭԻȡһ
         }
         else if (decode_ret == AVERROR_EOF) {
             cout << "MediaPlayer AudioDecodeThread: Decoder signaled EOF during decoding." << endl;
@@ -1155,6 +1958,9 @@ int MediaPlayer::audio_decode_func() {
         m_audioFrameQueue->signal_eof();
     }
 
+    // ͷ߳ڸõĽ֡
+    av_frame_free(&decoded_frame);
+
     return 0;
 }
 
@@ -1165,10 +1971,7 @@ int MediaPlayer::video_render_thread_entry(void* opaque) {
 
 int MediaPlayer::video_render_func() {
     cout << "MediaPlayer: VideoRenderThread started." << endl;
-    if (!m_renderingVideoFrame) {
-        cerr << "MediaPlayer VideoRenderThread Error: m_renderingVideoFrame is null." << endl;
-        return -1;
-    }
+    int render_serial = m_seek_serial.load(); // Ⱦǰͬ״̬
 
     while (!m_quit) {
         // ״̬ȴ߼
@@ -1180,45 +1983,103 @@ int MediaPlayer::video_render_func() {
         }
         if (m_quit) break;
 
-        // ԴӶлȡ֡
-        bool got_new_frame = m_videoFrameQueue->pop(m_renderingVideoFrame, -1);
-
-        if (got_new_frame) {
-            // Ҫӳٶ
-            double delay = m_videoRenderer->calculateSyncDelay(m_renderingVideoFrame);
-            // յ֡źţͷŵǰ֡ʼһѭԻȡ֡
-            // Ϊ˱⸡ȽϵǱ⣬ʹ < 0.0 ж֡Ƿٵ
-            if (delay < 0.0) {
-                cout << "MediaPlayer VideoRenderThread: Dropping a frame to catch up." << endl;
-                av_frame_unref(m_renderingVideoFrame);
-                continue; // ֱ while ѭһε
+        // ȴ֡֡ڶ (ӡ)ֱ next() Ϊֹ
+        AVFrame* vp = m_videoFrameQueue->peek_readable(-1);
+        if (!vp) {
+            cout << "MediaPlayer VideoRenderThread: peek_readable() returned null, exiting loop." << endl;
+            break;
+        }
+
+        // һ֡ѽͬһУ PTS 㱾֡ʵʱ
+        int serial = 0;
+        m_videoFrameQueue->peek(&serial);
+
+        // еĵһ֡λȾ֡ƣ֡ǿʾ
+        if (serial != render_serial) {
+            m_videoRenderer->flush();
+            render_serial = serial;
+        }
+        const AVFrame* next_vp = nullptr;
+        if (m_videoFrameQueue->nb_remaining() > 1) {
+            int next_serial = 0;
+            AVFrame* candidate = m_videoFrameQueue->peek_next(&next_serial);
+            if (next_serial == serial) {
+                next_vp = candidate;
             }
+        }
 
-            if (delay > 0.0) {
-                SDL_Delay(static_cast<Uint32>(delay * 1000.0));
+        // Ҫӳٶ
+        double delay = m_videoRenderer->calculateSyncDelay(vp, next_vp);
+        // յ֡źţǰ֡ʼһѭԻȡ֡
+        // Ϊ˱⸡ȽϵǱ⣬ʹ < 0.0 ж֡Ƿٵ
+        if (delay < 0.0) {
+            cout << "MediaPlayer VideoRenderThread: Dropping a frame to catch up." << endl;
+            if (m_frameSkip) {
+                m_frameSkip->onFrame(true);
             }
+            if (m_debugStats) {
+                m_debugStats->render_dropped_frames++;
+            }
+            m_videoFrameQueue->next();
+            continue; // ֱ while ѭһε
+        }
+
+        if (delay > 0.0) {
+            SDL_Delay(static_cast<Uint32>(delay * 1000.0));
+        }
 
-            // ѾΪ m_quit = true ѣһٷ¼
-            if (m_quit) break;
+        // ѾΪ m_quit = true ѣһٷ¼
+        if (m_quit) break;
+
+        // ׼Ⱦ (sws_scale)һCPUܼͲʺϷڸù߳
+        // ֻ׼ã
+        if (!m_videoRenderer->prepareFrameForDisplay(vp)) {
+            cerr << "MediaPlayer VideoRenderThread: prepareFrameForDisplay failed." << endl;
+            // һ󣬿Լ
+        }
 
-            // ׼Ⱦ (sws_scale)һCPUܼͲʺϷڸù߳
-            // ֻ׼ã
-            if (!m_videoRenderer->prepareFrameForDisplay(m_renderingVideoFrame)) {
-                cerr << "MediaPlayer VideoRenderThread: prepareFrameForDisplay failed." << endl;
-                // һ󣬿Լ
+        // תеĵһ֡¼ʾӳ
+        int latency_serial = serial;
+        if (m_seek_latency_serial.compare_exchange_strong(latency_serial, -1)) {
+            double latency_ms = (SDL_GetPerformanceCounter() - m_seek_latency_start.load()) * 1000.0
+                / SDL_GetPerformanceFrequency();
+            m_seek_in_flight = false;
+            if (m_debugStats) {
+                unsigned long long count = ++m_debugStats->seek_count;
+                m_debugStats->seek_last_ms = latency_ms;
+                m_debugStats->seek_avg_ms = m_debugStats->seek_avg_ms.load() + (latency_ms - m_debugStats->seek_avg_ms.load()) / count;
             }
+            cout << "MediaPlayer VideoRenderThread: Seek-to-first-frame latency " << latency_ms << " ms." << endl;
+        }
 
-            // ˢ¼֪ͨ߳
-            SDL_Event event;
-            event.type = FF_REFRESH_EVENT;
-            SDL_PushEvent(&event);
+        if (m_demuxer->isLiveStream()) {
+            record_live_latency(vp);
+        }
 
-            av_frame_unref(m_renderingVideoFrame);
+        // ߳ʾ֡ǵ֡ͬǶ֡
+        unsigned int overwritten = m_videoRenderer->takeOverwrittenFrames();
+        if (overwritten > 0 && m_debugStats) {
+            m_debugStats->render_dropped_frames += overwritten;
         }
-        else {
-            cout << "MediaPlayer VideoRenderThread: pop() returned false, exiting loop." << endl;
-            break;
+
+        if (m_frameSkip) {
+            for (unsigned int i = 0; i < overwritten; i++) {
+                m_frameSkip->onFrame(true);
+            }
+            m_frameSkip->onFrame(false);
+            if (m_debugStats) {
+                m_debugStats->frame_skip_level = m_frameSkip->getLevel();
+                m_debugStats->frame_skip_escalations = m_frameSkip->getEscalations();
+            }
         }
+
+        // ǰ֡ѴϲͷţػʹȾԼ
+        m_videoFrameQueue->next();
+
+        // ˢ¼֪ͨ߳
+        SDL_Event event;
+        event.type = FF_REFRESH_EVENT;
+        SDL_PushEvent(&event);
     }
 
     // ߳˳ǰһ˳źţȷѭܱѲ˳
@@ -1229,6 +2090,15 @@ int MediaPlayer::video_render_func() {
     return 0;
 }
 
+void MediaPlayer::wait_for_new_serial(PacketQueue* queue, int eof_serial) {
+    cout << "MediaPlayer: Decoder drained, waiting for a seek or quit." << endl;
+    // תڽװ߳екŲλе EOF֮û֪̼ͨѯ
+    std::unique_lock<std::mutex> lock(m_state_mutex);
+    while (!m_quit.load() && m_seek_serial.load() == eof_serial && queue->is_eof()) {
+        m_state_cond.wait_for(lock, std::chrono::milliseconds(20));
+    }
+}
+
 // ƵȾ߳ں
 int MediaPlayer::audio_render_thread_entry(void* opaque) {
     return static_cast<MediaPlayer*>(opaque)->audio_render_func();
@@ -1236,8 +2106,8 @@ int MediaPlayer::audio_render_thread_entry(void* opaque) {
 
 int MediaPlayer::audio_render_func() {
     cout << "MediaPlayer: Audio render thread started." << endl;
-    if (!m_renderingAudioFrame) {
-        cerr << "MediaPlayer AudioRenderThread Error: m_renderingAudioFrame is null." << endl;
+    if (!m_renderingAudioFrames[0]) {
+        cerr << "MediaPlayer AudioRenderThread Error: m_renderingAudioFrames is null." << endl;
         return -1;
     }
 
@@ -1251,14 +2121,15 @@ int MediaPlayer::audio_render_func() {
         }
         if (m_quit) break;
 
-        // Ƶ֡ȡһ֡
-        if (!m_audioFrameQueue->pop(m_renderingAudioFrame, -1)) {
-            cout << "MediaPlayer AudioRenderThread: pop() returned false, exiting loop." << endl;
+        // Ƶ֡һȡǰѾһ֡
+        size_t count = m_audioFrameQueue->pop_batch(m_renderingAudioFrames, AUDIO_RENDER_BATCH, -1);
+        if (count == 0) {
+            cout << "MediaPlayer AudioRenderThread: pop_batch() returned no frames, exiting loop." << endl;
             break;
         }
 
-        // Ⱦһ֡
-        if (m_audioRenderer && !m_audioRenderer->renderFrame(m_renderingAudioFrame, m_quit)) {
+        // Ⱦһ֡ (زһ)
+        if (m_audioRenderer && !m_audioRenderer->renderFrames(m_renderingAudioFrames, static_cast<int>(count), m_quit)) {
             //  renderFrame Ϊ˳ false׼˳߳
             if (!m_quit) {
                 cerr << "MediaPlayer AudioRenderThread: renderFrame failed." << endl;
@@ -1266,13 +2137,57 @@ int MediaPlayer::audio_render_func() {
             }
         }
 
-        // ͷŶ֡ݵãԱ m_renderingAudioFrame Ա
-        av_frame_unref(m_renderingAudioFrame);
+        // ͷŶ֡ݵãԱ m_renderingAudioFrames Ա
+        for (size_t i = 0; i < count; ++i) {
+            av_frame_unref(m_renderingAudioFrames[i]);
+        }
     }
 
     return 0;
 }
 
+// ɼͳ
+void MediaPlayer::publish_queue_stats(bool dump) {
+    if (!m_debugStats) return;
+
+    QueueStatsSnapshot stats[QSTATS_COUNT];
+    if (m_videoPacketQueue) stats[QSTATS_VIDEO_PACKET] = m_videoPacketQueue->takeStats();
+    if (m_audioPacketQueue) stats[QSTATS_AUDIO_PACKET] = m_audioPacketQueue->takeStats();
+    if (m_videoFrameQueue) stats[QSTATS_VIDEO_FRAME] = m_videoFrameQueue->takeStats();
+    if (m_audioFrameQueue) stats[QSTATS_AUDIO_FRAME] = m_audioFrameQueue->takeStats();
+
+    // һοյĲֵ
+    Uint32 now = SDL_GetTicks();
+    double elapsed_sec = (now - m_prevQueueStatsTicks) / 1000.0;
+    for (int i = 0; i < QSTATS_COUNT; ++i) {
+        if (m_prevQueueStatsTicks != 0 && elapsed_sec > 0.0) {
+            stats[i].push_rate = (stats[i].pushes - m_prevQueueStats[i].pushes) / elapsed_sec;
+            stats[i].pop_rate = (stats[i].pops - m_prevQueueStats[i].pops) / elapsed_sec;
+        }
+        m_prevQueueStats[i] = stats[i];
+    }
+    m_prevQueueStatsTicks = now;
+
+    {
+        std::lock_guard<std::mutex> lock(m_debugStats->queue_stats_mutex);
+        for (int i = 0; i < QSTATS_COUNT; ++i) {
+            m_debugStats->queue_stats[i] = stats[i];
+        }
+    }
+
+    // ɶĵ JSONвɼͱȶ
+    if (dump) {
+        std::ostringstream oss;
+        oss << "{\"t_ms\":" << now << ",\"state\":" << static_cast<int>(m_playerState.load());
+        for (int i = 0; i < QSTATS_COUNT; ++i) {
+            oss << ",\"" << queueStatsKey(i) << "\":";
+            stats[i].writeJson(oss);
+        }
+        oss << "}";
+        cout << "[QueueStats] " << oss.str() << endl;
+    }
+}
+
 // ܿ߳ں
 int MediaPlayer::control_thread_entry(void* opaque) {
     return static_cast<MediaPlayer*>(opaque)->control_thread_func();
@@ -1297,9 +2212,21 @@ int MediaPlayer::control_thread_func() {
         return -1;
     }
 
+    Uint32 last_dump_ticks = SDL_GetTicks();
+
     while (!m_quit) {
         SDL_Delay(20);
 
+        // ʱͳ
+        Uint32 now_ticks = SDL_GetTicks();
+        if (now_ticks - m_prevQueueStatsTicks >= QUEUE_STATS_PUBLISH_INTERVAL_MS) {
+            bool dump = QUEUE_STATS_DUMP_INTERVAL_MS > 0 && now_ticks - last_dump_ticks >= QUEUE_STATS_DUMP_INTERVAL_MS;
+            if (dump) {
+                last_dump_ticks = now_ticks;
+            }
+            publish_queue_stats(dump);
+        }
+
         // ʱͬʱԴ״̬Ϣ
         if (m_clockManager && m_debugStats) {
             int display_clock_type = 0;
@@ -1318,6 +2245,44 @@ int MediaPlayer::control_thread_func() {
             m_debugStats->clock_source_type = display_clock_type;
         }
 
+        // ʱͬ֡еĳפڴ浽Ϣ
+        if (m_debugStats) {
+            if (m_videoFrameQueue) {
+                m_debugStats->vf_size = static_cast<int>(m_videoFrameQueue->nb_remaining());
+                m_debugStats->vf_bytes = m_videoFrameQueue->getTotalBytes();
+            }
+            if (m_audioFrameQueue) {
+                m_debugStats->af_bytes = m_audioFrameQueue->getTotalBytes();
+            }
+            // Ԥ
+            ReadAheadStats io_stats;
+            auto ffmpegDemuxer = dynamic_cast<FFmpegDemuxer*>(m_demuxer.get());
+            if (ffmpegDemuxer && ffmpegDemuxer->getReadAheadStats(io_stats)) {
+                m_debugStats->io_hits = io_stats.hits;
+                m_debugStats->io_misses = io_stats.misses;
+                m_debugStats->io_wait_ms = io_stats.miss_wait_us / 1000;
+            }
+            // ͳ
+            if (ffmpegDemuxer && ffmpegDemuxer->isLiveStream()) {
+                ReconnectStats rc_stats = ffmpegDemuxer->getReconnectStats();
+                m_debugStats->live_outages = rc_stats.outages;
+                m_debugStats->live_reconnect_attempts = rc_stats.attempts;
+                m_debugStats->live_reconnecting = rc_stats.reconnecting;
+                m_debugStats->live_reconnect_ms = rc_stats.last_reconnect_ms;
+                m_debugStats->live_outage_total_ms = rc_stats.total_outage_ms;
+            }
+            // ¼״̬
+            if (m_recorder) {
+                RecorderStats rec_stats = m_recorder->getStats();
+                m_debugStats->recording = rec_stats.recording;
+                m_debugStats->record_mb = rec_stats.bytes_written / (1024.0 * 1024.0);
+                m_debugStats->record_segments = rec_stats.segments;
+                m_debugStats->record_queue_kb = rec_stats.queued_bytes >> 10;
+                m_debugStats->record_dropped_pkts = rec_stats.packets_dropped;
+                m_debugStats->record_gaps = rec_stats.gaps;
+            }
+        }
+
         // ȡǰPacketQueueĻʱ룩
         // ȻƵм㣬ƵƵ
         double current_buffer_sec = 0.0;
@@ -1340,6 +2305,11 @@ int MediaPlayer::control_thread_func() {
         PlayerState current_state = m_playerState.load();
         bool is_live_stream = m_demuxer && m_demuxer->isLiveStream();
 
+        // ֱ׷ֱֻ֡Եʱ٣/ͣ/ʱƻؿʱصԭ
+        if (is_live_stream && LIVE_CATCH_UP) {
+            update_live_playback_rate(current_state == PlayerState::PLAYING && !m_timeshifted.load());
+        }
+
         // --- ߼ ---
         switch (current_state) {
         case PlayerState::BUFFERING:
@@ -1348,7 +2318,18 @@ int MediaPlayer::control_thread_func() {
 
             bool should_play = false;
 
-            if (is_live_stream) {
+            if (is_live_stream && m_low_latency) {
+                // ֱ-ӳ ԡ
+                // ֻһСĶ (Լ 150ms) ͿʼţܵʱֱӼ˵ӳ
+                int pkt_count = videoStreamIndex != -1 ? video_pkt_count : audio_pkt_count;
+                if (current_buffer_sec >= LOW_LATENCY_JITTER_SEC ||
+                    (current_buffer_sec <= 0.0 && pkt_count >= LOW_LATENCY_JITTER_PKTS)) {
+                    cout << "MediaPlayer: LIVE stream reached low-latency jitter target (" << video_pkt_count
+                        << " pkts, " << current_buffer_sec << "s). Resuming." << endl;
+                    should_play = true;
+                }
+            }
+            else if (is_live_stream) {
                 // ֱ ԡ
                 //  0.5  OR 25ԼƵſʼ
                 // Լ 500ms /ָӳ٣ܱ֤ŵ
@@ -1384,6 +2365,10 @@ int MediaPlayer::control_thread_func() {
             {
                 // ֻеƵڣҶĿˣŽ뻺
                 bool is_empty = (videoStreamIndex != -1 && video_pkt_count == 0);
+                // ӳģʽ°һͱ룬гǿյģֻѽ֡Ҳľʱ
+                if (m_low_latency && is_empty && m_videoFrameQueue && m_videoFrameQueue->nb_remaining() > 0) {
+                    is_empty = false;
+                }
 
                 // ȫûδʱŽ뻺
                 if (is_empty && !m_demuxer_eof.load()) {
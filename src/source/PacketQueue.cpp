@@ -20,197 +20,665 @@
 
 #include "../include/PacketQueue.h"
 #include <iostream>
+#include <stdexcept>	// std::runtime_error
+#include <thread>		// std::this_thread::yield
+#include <cstdint>		// intptr_t
 
 using namespace std;
 
-PacketQueue::PacketQueue(size_t max_packet_count, int64_t max_duration_in_ts, bool block_on_full)
-	: max_size(max_packet_count), 
+PacketQueue::PacketQueue(size_t max_packet_count, int64_t max_duration_in_ts, bool block_on_full,
+	size_t max_bytes_limit)
+	: m_capacity(max_packet_count > 0 ? max_packet_count : DEFAULT_RING_CAPACITY),
+	m_block_on_full(block_on_full),
+	max_size(max_packet_count),
 	max_duration_ts(max_duration_in_ts),
-	m_block_on_full(block_on_full)
+	max_bytes(max_bytes_limit)
 {
+	// һԤвλ AVPacketڼ䲻ٷ
+	m_slots.reset(new PacketSlot[m_capacity]);
+	for (size_t i = 0; i < m_capacity; ++i) {
+		m_slots[i].seq.store(i, std::memory_order_relaxed);
+		m_slots[i].pkt = av_packet_alloc();
+		if (!m_slots[i].pkt) {
+			// ͷѷĲֹ֣ڴй©
+			for (size_t j = 0; j < i; ++j) {
+				av_packet_free(&m_slots[j].pkt);
+			}
+			throw std::runtime_error("PacketQueue: av_packet_alloc failed for ring slot.");
+		}
+	}
 }
 
 PacketQueue::~PacketQueue() { 
 	clear(); 
+	for (size_t i = 0; i < m_capacity; ++i) {
+		av_packet_free(&m_slots[i].pkt);
+	}
 }
 
-bool PacketQueue::push(AVPacket* packet, int serial) {
-	if (!packet) {
-		cerr << "PacketQueue::push: Input packet is null." << endl;
-		return false;
+bool PacketQueue::hasData() const {
+	for (;;) {
+		size_t pos = m_head.load(std::memory_order_acquire);
+		size_t seq = m_slots[pos % m_capacity].seq.load(std::memory_order_acquire);
+		intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+		if (diff == 0) return true;
+		if (diff < 0) return false;
+		// diff > 0òλѱȡ߲黹λѹڣ¶ȡ
 	}
+}
 
-	AVPacket* pkt_clone = av_packet_alloc();
-	if (!pkt_clone) {
-		cerr << "PacketQueue::push: av_packet_alloc failed." << endl;
-		return false;
+bool PacketQueue::hasFreeSlot() const {
+	// ߵãдλòᱻ߳޸
+	size_t pos = m_tail.load(std::memory_order_relaxed);
+	return m_slots[pos % m_capacity].seq.load(std::memory_order_acquire) == pos;
+}
+
+bool PacketQueue::tryTake(AVPacket* out, int* serial, size_t end_pos, bool notify) {
+	size_t pos = m_head.load(std::memory_order_relaxed);
+	for (;;) {
+		if (pos >= end_pos) {
+			return false; // ѵﶪ߽
+		}
+		PacketSlot& slot = m_slots[pos % m_capacity];
+		size_t seq = slot.seq.load(std::memory_order_acquire);
+		intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+		if (diff == 0) {
+			// λд룬ռʧʱ pos ᱻΪµĶλ
+			// (seq_cst߶ m_drop_until д빹ȫ)
+			if (m_head.compare_exchange_weak(pos, pos + 1)) {
+				m_total_bytes.fetch_sub(slot.size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				m_total_duration.fetch_sub(slot.duration.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+				// ڶ GOP еİʧЧľɴʰ͵ػգȡһ
+				bool in_dropping_gop = pos < m_drop_until.load();
+				if (out && (in_dropping_gop || slot.serial < m_min_serial.load())) {
+					av_packet_unref(slot.pkt);
+					if (in_dropping_gop) {
+						m_dropped_packets.fetch_add(1, std::memory_order_relaxed);
+					}
+					slot.seq.store(pos + m_capacity, std::memory_order_release);
+					wakeProducer();
+					pos = m_head.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if (serial) {
+					*serial = slot.serial;
+				}
+				if (out) {
+					// ƽãҲü
+					av_packet_unref(out);
+					av_packet_move_ref(out, slot.pkt);
+				}
+				else {
+					av_packet_unref(slot.pkt);
+				}
+				// 黹λһȦд
+				slot.seq.store(pos + m_capacity, std::memory_order_release);
+				if (out) {
+					m_stats.onPop(size());
+				}
+				if (notify) {
+					wakeProducer();
+				}
+				return true;
+			}
+		}
+		else if (diff < 0) {
+			return false; // Ϊ
+		}
+		else {
+			pos = m_head.load(std::memory_order_relaxed);
+		}
 	}
-	if (av_packet_ref(pkt_clone, packet) < 0) {
-		cerr << "PacketQueue::push: av_packet_ref failed." << endl;
-		av_packet_free(&pkt_clone);
+}
+
+void PacketQueue::wakeConsumer() {
+	// ȴԼ޸Ĺȫ򣬱֤
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_waiting_consumers.load(std::memory_order_relaxed) > 0) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto locked_at = QueueStats::now();
+		cond_consumer.notify_one();
+		m_stats.onLockHold(locked_at);
+	}
+}
+
+void PacketQueue::wakeProducer() {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_waiting_producers.load(std::memory_order_relaxed) > 0) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto locked_at = QueueStats::now();
+		cond_producer.notify_one();
+		m_stats.onLockHold(locked_at);
+	}
+}
+
+bool PacketQueue::overBudget(size_t incoming_bytes) const {
+	// Ԥģʽ£ʱ/ֽԤֻ hasEnoughPackets() жϣ
+	return !m_soft_budget.load(std::memory_order_relaxed) && budgetReached(incoming_bytes);
+}
+
+bool PacketQueue::budgetReached(size_t incoming_bytes) const {
+	// Ϊʱ룬ⵥʹؼ֡Զ޷
+	if (!hasData()) {
 		return false;
 	}
 
-	std::unique_lock<std::mutex> lock(mutex);
+	int64_t duration_limit = max_duration_ts.load(std::memory_order_relaxed);
+	if (duration_limit > 0 && m_total_duration.load(std::memory_order_relaxed) >= duration_limit) {
+		return true;
+	}
+
+	size_t bytes_limit = max_bytes.load(std::memory_order_relaxed);
+	if (bytes_limit > 0 && m_total_bytes.load(std::memory_order_relaxed) + incoming_bytes > bytes_limit) {
+		return true;
+	}
+	return false;
+}
 
+bool PacketQueue::reserveSlot(const AVPacket* incoming) {
 	// ǷҪֹ
 	if (m_abort_request.load() || eof_signaled.load()) {
-		av_packet_free(&pkt_clone);
 		return false;
 	}
 
-	// Ƿ
-	bool is_full = (max_size > 0 && queue.size() >= max_size);
+	size_t incoming_bytes = incoming->size > 0 ? static_cast<size_t>(incoming->size) : 0;
 
-	if (is_full) {
-		if (m_block_on_full) {
-			// ļģʽȴֱ
-			while (is_full && !m_abort_request.load()) {
-				cond_producer.wait(lock);
-				// Ѻ¼״̬
-				is_full = (max_size > 0 && queue.size() >= max_size);
-			}
+	if (hasFreeSlot() && !overBudget(incoming_bytes)) {
+		return true;
+	}
+
+	// ȻնʧЧľɴʰǲӦռݵĿռ
+	purgeStale();
+
+	if (m_block_on_full) {
+		// ļģʽȴֱпλһ䵽Ԥ
+		for (;;) {
 			if (m_abort_request.load()) {
-				av_packet_free(&pkt_clone);
 				return false;
 			}
-		}
-		else {
-			// ֱģʽɰ
-			while ((max_size > 0 && queue.size() >= max_size))
+			if (hasFreeSlot() && !overBudget(incoming_bytes)) {
+				return true;
+			}
 			{
-				if (queue.empty()) break;
-				// 
-				PacketData old_data = queue.front();
-				queue.pop();
-				// ͳ
-				m_total_bytes -= old_data.pkt->size;
-				av_packet_free(&old_data.pkt);
-				// cout << "Drop packet for live stream latency control" << endl;
+				auto wait_start = QueueStats::now();
+				std::unique_lock<std::mutex> lock(mutex);
+				m_waiting_producers++;
+				cond_producer.wait(lock, [this, incoming_bytes] {
+					return (hasFreeSlot() && !overBudget(incoming_bytes)) || hasStaleHead() || m_abort_request.load();
+					});
+				m_waiting_producers--;
+				m_stats.onProducerWait(wait_start);
 			}
+			//  invalidate() ѣվɴʰж
+			purgeStale();
 		}
 	}
 
-	// °Ӳͳ
-	queue.push(PacketData{ pkt_clone, serial });
-	m_total_bytes += pkt_clone->size;
-
-	lock.unlock();
-	cond_consumer.notify_one();
+	// ֱģʽ GOP ɰֱλԤ
+	size_t tail = m_tail.load(std::memory_order_relaxed);
+	while (!hasFreeSlot() || overBudget(incoming_bytes)) {
+		if (m_abort_request.load()) {
+			return false;
+		}
+		if (tail - m_head.load(std::memory_order_acquire) >= m_capacity || overBudget(incoming_bytes)) {
+			// ȷʵ򳬳Ԥ
+			if (!dropOldestGop(incoming)) {
+				return false; // ûкؼ֡Ϊ°
+			}
+		}
+		else {
+			// ռж׵δ黹λò
+			std::this_thread::yield();
+		}
+	}
 	return true;
 }
 
-bool PacketQueue::pop(AVPacket* packet, int& serial, int timeout_ms) {
-	if (!packet) {
-		cerr << "PacketQueue::pop: Output packet parameter is null." << endl;
+bool PacketQueue::hasStaleHead() const {
+	size_t pos = m_head.load(std::memory_order_acquire);
+	const PacketSlot& slot = m_slots[pos % m_capacity];
+	if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
 		return false;
 	}
+	return slot.serial < m_min_serial.load(std::memory_order_relaxed);
+}
 
-	std::unique_lock<std::mutex> lock(mutex);
-
-	while (queue.empty() && !eof_signaled.load() && !m_abort_request.load()) {
-		if (timeout_ms == 0) {
-			return false;
+size_t PacketQueue::purgeStale() {
+	size_t purged = 0;
+	for (;;) {
+		size_t pos = m_head.load(std::memory_order_acquire);
+		const PacketSlot& slot = m_slots[pos % m_capacity];
+		if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
+			break; // ѿ
 		}
-		if (timeout_ms < 0) {
-			cond_consumer.wait(lock);
+		if (slot.serial >= m_min_serial.load(std::memory_order_relaxed)) {
+			break; // ɴʵİڶУЧֹͣ
 		}
-		else {
-			if (cond_consumer.wait_for(lock, std::chrono::milliseconds(timeout_ms)) == std::cv_status::timeout) {
-				return false;
-			}
+		// ֻռиλãѱȡߣ¼µĶ
+		if (tryTake(nullptr, nullptr, pos + 1)) {
+			++purged;
 		}
 	}
+	return purged;
+}
 
-	// ǷֹEOF˳ȴ
-	if (m_abort_request.load()) {
+bool PacketQueue::skipIncoming(const AVPacket* incoming) {
+	if (!m_skip_to_keyframe.load(std::memory_order_relaxed)) {
 		return false;
 	}
-	if (queue.empty() && eof_signaled.load()) {
+	if (incoming->flags & AV_PKT_FLAG_KEY) {
+		// µ GOP ʼָӣеδƵü¼
+		m_skip_to_keyframe.store(false, std::memory_order_relaxed);
 		return false;
 	}
+	m_dropped_packets.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
 
-	PacketData src_data = queue.front();
-	queue.pop();
+size_t PacketQueue::dropUntil(size_t end_pos) {
+	// ȹ߽磬֮ռеı߽ǰİᱻж
+	m_drop_until.store(end_pos);
 
-	// ͬͳ
-	m_total_bytes -= src_data.pkt->size;
+	size_t dropped = 0;
+	while (m_head.load(std::memory_order_acquire) < end_pos) {
+		if (tryTake(nullptr, nullptr, end_pos)) {
+			++dropped;
+		}
+		else {
+			// ױռеδ黹ò
+			std::this_thread::yield();
+		}
+	}
+	m_dropped_packets.fetch_add(dropped, std::memory_order_relaxed);
+	return dropped;
+}
 
-	lock.unlock();
+bool PacketQueue::dropOldestGop(const AVPacket* incoming) {
+	m_drop_events.fetch_add(1, std::memory_order_relaxed);
+
+	// дδֹؼ֡ǣȫǹؼ֡Ƶ GOP 壬˻Ϊ
+	if (!m_seen_keyframe.load(std::memory_order_relaxed)) {
+		if (tryTake(nullptr, nullptr)) {
+			m_dropped_packets.fetch_add(1, std::memory_order_relaxed);
+		}
+		return true;
+	}
+
+	// Ӷ֮һؼ֡λ key ǽɱ߳д룬ֱӶȡ
+	size_t head = m_head.load(std::memory_order_acquire);
+	size_t tail = m_tail.load(std::memory_order_relaxed);
+	for (size_t pos = head + 1; pos < tail; ++pos) {
+		const PacketSlot& slot = m_slots[pos % m_capacity];
+		if (slot.key) {
+			// ǰ GOP ʣಿ֣öдһؼ֡ʼ
+			dropUntil(pos);
+			m_resume_pts.store(slot.pts.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	if (incoming->flags & AV_PKT_FLAG_KEY) {
+		// °һ GOP 㣬еȫݶѹʱ
+		dropUntil(tail);
+		m_resume_pts.store(incoming->pts, std::memory_order_relaxed);
+		return true;
+	}
+
+	// ֻʣǰ GOP°Լ֮ķǹؼ֡
+	m_skip_to_keyframe.store(true, std::memory_order_relaxed);
+	m_dropped_packets.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
 
-	//  Packet 
-	av_packet_unref(packet);
-	if (av_packet_ref(packet, src_data.pkt) < 0) {
-		cerr << "PacketQueue::pop: av_packet_ref failed." << endl;
-		av_packet_free(&src_data.pkt);
+int64_t PacketQueue::estimatePacketDuration(const AVPacket* pkt) {
+	int64_t ts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
+	int64_t last_ts = m_last_ts.load(std::memory_order_relaxed);
+	if (ts != AV_NOPTS_VALUE) {
+		m_last_ts.store(ts, std::memory_order_relaxed);
+	}
+
+	// 1. װʱֱʹ
+	if (pkt->duration > 0) {
+		m_last_pkt_duration.store(pkt->duration, std::memory_order_relaxed);
+		return pkt->duration;
+	}
+
+	int64_t fallback = m_last_pkt_duration.load(std::memory_order_relaxed);
+	if (ts == AV_NOPTS_VALUE || last_ts == AV_NOPTS_VALUE) {
+		return fallback;
+	}
+
+	// 2. ڰʱֵ
+	int64_t delta = ts - last_ts;
+	if (delta < 0) {
+		//  33 λʱ (MPEG-TS)һж
+		delta += TS_WRAP_PERIOD;
+	}
+
+	// 3. ֵ򡢶ѻ䣩ΪʱһЧĵʱ
+	int64_t duration_limit = max_duration_ts.load(std::memory_order_relaxed);
+	int64_t plausible_limit = duration_limit > 0 ? duration_limit : TS_WRAP_PERIOD / 2;
+	if (delta <= 0 || delta > plausible_limit) {
+		return fallback;
+	}
+
+	m_last_pkt_duration.store(delta, std::memory_order_relaxed);
+	return delta;
+}
+
+void PacketQueue::publishSlot(int serial) {
+	size_t pos = m_tail.load(std::memory_order_relaxed);
+	PacketSlot& slot = m_slots[pos % m_capacity];
+	const AVPacket* pkt = slot.pkt;
+
+	int64_t duration = estimatePacketDuration(pkt);
+
+	slot.serial = serial;
+	slot.pts.store(pkt->pts, std::memory_order_relaxed);
+	slot.size.store(pkt->size, std::memory_order_relaxed);
+	slot.duration.store(duration, std::memory_order_relaxed);
+	slot.key = (pkt->flags & AV_PKT_FLAG_KEY) != 0;
+	if (slot.key) {
+		m_seen_keyframe.store(true, std::memory_order_relaxed);
+	}
+	m_total_bytes.fetch_add(pkt->size, std::memory_order_relaxed);
+	m_total_duration.fetch_add(duration, std::memory_order_relaxed);
+
+	// ߲ſɼ
+	slot.seq.store(pos + 1, std::memory_order_release);
+	m_tail.store(pos + 1, std::memory_order_release);
+	m_stats.onPush(size());
+
+	wakeConsumer();
+}
+
+bool PacketQueue::push(const AVPacket* packet, int serial) {
+	if (!packet) {
+		cerr << "PacketQueue::push: Input packet is null." << endl;
+		return false;
+	}
+	if (!m_block_on_full && skipIncoming(packet)) {
+		return false;
+	}
+	if (!reserveSlot(packet)) {
 		return false;
 	}
 
-	//  serial
-	serial = src_data.serial;
+	// °õλ
+	AVPacket* slot_pkt = m_slots[m_tail.load(std::memory_order_relaxed) % m_capacity].pkt;
+	if (av_packet_ref(slot_pkt, packet) < 0) {
+		cerr << "PacketQueue::push: av_packet_ref failed." << endl;
+		return false;
+	}
 
-	av_packet_free(&src_data.pkt);
+	publishSlot(serial);
+	return true;
+}
 
-	// ѿڵȴ
-	if (m_block_on_full) {
-		cond_producer.notify_one();
+bool PacketQueue::push(AVPacket*&& packet, int serial) {
+	if (!packet) {
+		cerr << "PacketQueue::push: Input packet is null." << endl;
+		return false;
+	}
+	if (!m_block_on_full && skipIncoming(packet)) {
+		return false;
 	}
+	if (!reserveSlot(packet)) {
+		return false;
+	}
+
+	// ֱƽã䡢ü
+	AVPacket* slot_pkt = m_slots[m_tail.load(std::memory_order_relaxed) % m_capacity].pkt;
+	av_packet_move_ref(slot_pkt, packet);
 
+	publishSlot(serial);
 	return true;
 }
 
-size_t PacketQueue::size() const {
-	std::lock_guard<std::mutex> lock(mutex);
-	return queue.size();
+bool PacketQueue::pop(AVPacket* packet, int& serial, int timeout_ms) {
+	if (!packet) {
+		cerr << "PacketQueue::pop: Output packet parameter is null." << endl;
+		return false;
+	}
+
+	// ·зǿʱֱȡߣ
+	if (m_abort_request.load()) {
+		return false;
+	}
+	if (tryTake(packet, &serial)) {
+		return true;
+	}
+	if (timeout_ms == 0) {
+		return false;
+	}
+	// ߿ signal_eof() ֮ǰշһ۲쵽 EOF ȡһΣȷ϶ȷʵѿ
+	if (eof_signaled.load()) {
+		if (tryTake(packet, &serial)) {
+			return true;
+		}
+		if (!hasData()) {
+			return false;
+		}
+	}
+
+	// ·Ϊգϵȴ
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+	auto ready = [this] {
+		return hasData() || eof_signaled.load() || m_abort_request.load();
+		};
+
+	for (;;) {
+		{
+			auto wait_start = QueueStats::now();
+			std::unique_lock<std::mutex> lock(mutex);
+			m_waiting_consumers++;
+			bool woken = true;
+			if (timeout_ms < 0) {
+				cond_consumer.wait(lock, ready);
+			}
+			else {
+				woken = cond_consumer.wait_until(lock, deadline, ready);
+			}
+			m_waiting_consumers--;
+			m_stats.onConsumerWait(wait_start);
+			if (!woken) {
+				return false; // ȴʱ
+			}
+		}
+
+		// ǷֹEOF˳ȴ
+		if (m_abort_request.load()) {
+			return false;
+		}
+		if (tryTake(packet, &serial)) {
+			return true;
+		}
+		if (eof_signaled.load()) {
+			// ͬϣEOF ֮ǰһܱڶ
+			if (tryTake(packet, &serial)) {
+				return true;
+			}
+			if (!hasData()) {
+				return false;
+			}
+		}
+		// ݱ clear() ȡߣȴ
+	}
 }
 
-int64_t PacketQueue::getTotalDuration() const {
-	std::lock_guard<std::mutex> lock(mutex);
+size_t PacketQueue::pop_batch(AVPacket** packets, int* serials, size_t max_count, int timeout_ms) {
+	if (!packets || !serials || max_count == 0) {
+		cerr << "PacketQueue::pop_batch: Invalid output parameters." << endl;
+		return 0;
+	}
 
-	if (queue.empty()) {
+	// һ̵ȴ
+	if (!pop(packets[0], serials[0], timeout_ms)) {
 		return 0;
 	}
 
-	// ȡ׺Ͷβ
-	const PacketData& first = queue.front();
-	const PacketData& last = queue.back();
+	// ֻȡѾģٵȴҲ
+	size_t count = 1;
+	while (count < max_count && !m_abort_request.load() &&
+		tryTake(packets[count], &serials[count], SIZE_MAX, false)) {
+		count++;
+	}
+	if (count > 1) {
+		wakeProducer();
+	}
+	return count;
+}
+
+QueueStatsSnapshot PacketQueue::takeStats() {
+	QueueStatsSnapshot stats = m_stats.takeSnapshot(size());
+	stats.capacity = m_capacity;
+	stats.drops = m_dropped_packets.load(std::memory_order_relaxed);
+	return stats;
+}
+
+size_t PacketQueue::size() const {
+	// ȶλٶдλãֵ֤Ǹλռдλ÷֮˲ʱ״̬⣩
+	size_t head = m_head.load(std::memory_order_acquire);
+	size_t tail = m_tail.load(std::memory_order_acquire);
+	return tail > head ? tail - head : 0;
+}
 
-	//  PTS Ч (AV_NOPTS_VALUE)
-	if (first.pkt->pts == AV_NOPTS_VALUE || last.pkt->pts == AV_NOPTS_VALUE) {
-		// ޷ȡЧ PTS 0
+size_t PacketQueue::dropBefore(int64_t pts) {
+	if (pts == AV_NOPTS_VALUE) {
 		return 0;
 	}
 
-	int64_t duration = last.pkt->pts - first.pkt->pts;
+	size_t dropped = 0;
+	for (;;) {
+		size_t pos = m_head.load(std::memory_order_acquire);
+		const PacketSlot& slot = m_slots[pos % m_capacity];
+		if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
+			break; // ѿ
+		}
+		int64_t head_pts = slot.pts.load(std::memory_order_relaxed);
+		if (head_pts == AV_NOPTS_VALUE || head_pts >= pts) {
+			break;
+		}
+		// ֻڶǸòλʱѱȡߣ¼µĶ
+		if (tryTake(nullptr, nullptr, pos + 1)) {
+			++dropped;
+		}
+	}
 
-	//  PTS  (Wrap-around)  µĸֵ
-	if (duration < 0) {
-		return 0;
+	if (dropped > 0) {
+		m_dropped_packets.fetch_add(dropped, std::memory_order_relaxed);
+		m_drop_events.fetch_add(1, std::memory_order_relaxed);
 	}
+	return dropped;
+}
+
+bool PacketQueue::isSkippingToKeyframe() const {
+	return m_skip_to_keyframe.load(std::memory_order_relaxed);
+}
 
-	return duration;
+bool PacketQueue::takeGopDropEvent(int64_t& resume_pts) {
+	resume_pts = m_resume_pts.exchange(AV_NOPTS_VALUE, std::memory_order_relaxed);
+	return resume_pts != AV_NOPTS_VALUE;
+}
+
+uint64_t PacketQueue::getDroppedPackets() const {
+	return m_dropped_packets.load(std::memory_order_relaxed);
+}
+
+uint64_t PacketQueue::getDropEvents() const {
+	return m_drop_events.load(std::memory_order_relaxed);
+}
+
+void PacketQueue::setMaxDuration(int64_t max_duration_in_ts) {
+	max_duration_ts.store(max_duration_in_ts > 0 ? max_duration_in_ts : 0);
+	// Ԥſе߿ܿԼд
+	std::lock_guard<std::mutex> lock(mutex);
+	cond_producer.notify_all();
+}
+
+void PacketQueue::setMaxBytes(size_t max_bytes_limit) {
+	max_bytes.store(max_bytes_limit);
+	std::lock_guard<std::mutex> lock(mutex);
+	cond_producer.notify_all();
+}
+
+int64_t PacketQueue::getTotalDuration() const {
+	// Ӳʱܳ˲ʱֵضΪ 0
+	int64_t duration = m_total_duration.load(std::memory_order_relaxed);
+	return duration > 0 ? duration : 0;
 }
 
 size_t PacketQueue::getTotalBytes() const {
+	return m_total_bytes.load(std::memory_order_relaxed);
+}
+
+void PacketQueue::setSoftBudget(bool soft) {
+	m_soft_budget.store(soft);
+	// лΪԤԤ߿Լд
 	std::lock_guard<std::mutex> lock(mutex);
-	return m_total_bytes;
+	cond_producer.notify_all();
+}
+
+bool PacketQueue::hasEnoughPackets() const {
+	if (m_abort_request.load() || eof_signaled.load()) {
+		return true; // д룬Ϊȡ
+	}
+	if (hasStaleHead()) {
+		return false; // ɴδգЧ
+	}
+	return budgetReached(0) || size() >= m_capacity;
+}
+
+bool PacketQueue::hasMinimumPackets(size_t min_count) const {
+	if (m_abort_request.load() || eof_signaled.load()) {
+		return true;
+	}
+	if (hasStaleHead()) {
+		return false;
+	}
+	return size() >= min_count || budgetReached(0);
+}
+
+void PacketQueue::invalidate(int serial) {
+	// ֻʧЧޣͷκݰ
+	int current = m_min_serial.load();
+	while (serial > current && !m_min_serial.compare_exchange_weak(current, serial)) {}
+
+	// ʱ붪״̬´ʵݲ
+	m_last_ts.store(AV_NOPTS_VALUE);
+	m_last_pkt_duration.store(0);
+	m_skip_to_keyframe.store(false);
+	m_resume_pts.store(AV_NOPTS_VALUE);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	//  EOF ־ʹп½ (жϱ־˳̳ͻ)
+	eof_signaled = false;
+	lock.unlock();
+
+	// еߣվɰڳռ
+	cond_producer.notify_all();
+	cond_consumer.notify_all();
 }
 
 void PacketQueue::clear() {
+	// ߾ռжףͷ
+	while (tryTake(nullptr, nullptr)) {}
+
 	std::unique_lock<std::mutex> lock(mutex);
-	while (!queue.empty()) {
-		PacketData data = queue.front();
-		queue.pop();
-		av_packet_free(&data.pkt);
-	}
-	// ͳ
-	m_total_bytes = 0;
+	m_last_ts.store(AV_NOPTS_VALUE);
+	m_last_pkt_duration.store(0);
+	m_skip_to_keyframe.store(false);
+	m_resume_pts.store(AV_NOPTS_VALUE);
 
-	// ״̬־ʹ½
+	// ״̬־ʹп½
 	eof_signaled = false;
 	m_abort_request = false;
+	lock.unlock();
 
-	// ߺ߳
+	// ߺ߳
 	cond_consumer.notify_all();
 	cond_producer.notify_all();
 }
@@ -227,12 +695,11 @@ void PacketQueue::abort() {
 	m_abort_request.store(true);
 	lock.unlock();
 
-	// ߺ߳
+	// ߺ߳
 	cond_consumer.notify_all();
 	cond_producer.notify_all();
 }
 
 bool PacketQueue::is_eof() const {
-	std::lock_guard<std::mutex> lock(mutex);
-	return eof_signaled.load() && queue.empty();
+	return eof_signaled.load() && !hasData();
 }
@@ -0,0 +1,312 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/ReadAheadIOContext.h"
+#include <iostream>
+#include <cstring>		// memcpy, strcmp
+#include <chrono>
+#include <algorithm>	// std::min
+
+using namespace std;
+
+ReadAheadIOContext::ReadAheadIOContext(size_t read_ahead_bytes)
+	: m_ring(read_ahead_bytes > PREFETCH_CHUNK_SIZE * 2 ? read_ahead_bytes : PREFETCH_CHUNK_SIZE * 2),
+	m_back_reserve(m_ring.size() / 4)
+{
+}
+
+ReadAheadIOContext::~ReadAheadIOContext() {
+	close();
+}
+
+bool ReadAheadIOContext::isSupported(const char* url) {
+	if (!url) {
+		return false;
+	}
+	// ֻԵײ avio Эֱṩֽãrtsp ɽװй
+	const char* protocol = avio_find_protocol_name(url);
+	if (!protocol) {
+		return false;
+	}
+	return strcmp(protocol, "file") == 0 || strcmp(protocol, "http") == 0 || strcmp(protocol, "https") == 0;
+}
+
+int ReadAheadIOContext::open(const char* url, const AVIOInterruptCB* int_cb) {
+	close();
+
+	int ret = avio_open2(&m_inner, url, AVIO_FLAG_READ, int_cb, nullptr);
+	if (ret < 0) {
+		return ret;
+	}
+	m_file_size = avio_size(m_inner);
+
+	unsigned char* io_buffer = static_cast<unsigned char*>(av_malloc(IO_BUFFER_SIZE));
+	if (!io_buffer) {
+		avio_closep(&m_inner);
+		return AVERROR(ENOMEM);
+	}
+	m_outer = avio_alloc_context(io_buffer, IO_BUFFER_SIZE, 0, this,
+		&ReadAheadIOContext::readCallback, nullptr, &ReadAheadIOContext::seekCallback);
+	if (!m_outer) {
+		av_free(io_buffer);
+		avio_closep(&m_inner);
+		return AVERROR(ENOMEM);
+	}
+	// ײ㲻 seek ʱ (粿 HTTP Դ)ԶͬΪ seek
+	m_outer->seekable = m_inner->seekable;
+
+	// ״̬
+	m_window_start = m_read_pos = m_fill_pos = 0;
+	m_seek_target = -1;
+	m_eof = false;
+	m_error = 0;
+	m_stop = false;
+	m_abort = false;
+	m_stats = ReadAheadStats();
+
+	m_thread = std::thread(&ReadAheadIOContext::prefetchLoop, this);
+
+	cout << "ReadAheadIOContext: Opened with " << (m_ring.size() >> 10) << " KB read-ahead buffer." << endl;
+	return 0;
+}
+
+void ReadAheadIOContext::close() {
+	if (m_thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_cond_filler.notify_all();
+		m_cond_reader.notify_all();
+		// Ԥ߳̿ڵײȡϣɵײжϻص䷵
+		m_thread.join();
+
+		ReadAheadStats stats = getStats();
+		cout << "ReadAheadIOContext: Closed. Hits " << stats.hits << ", misses " << stats.misses
+			<< " (waited " << stats.miss_wait_us / 1000 << " ms), seeks in buffer " << stats.seeks_in_buffer
+			<< ", refills " << stats.seeks_refill << "." << endl;
+	}
+	if (m_outer) {
+		av_freep(&m_outer->buffer);
+		avio_context_free(&m_outer);
+	}
+	if (m_inner) {
+		avio_closep(&m_inner);
+	}
+	m_file_size = -1;
+}
+
+void ReadAheadIOContext::requestAbort(bool abort) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_abort = abort;
+	}
+	m_cond_reader.notify_all();
+	m_cond_filler.notify_all();
+}
+
+void ReadAheadIOContext::discardBuffered() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_read_pos = m_fill_pos;
+	}
+	m_cond_filler.notify_one();
+}
+
+ReadAheadStats ReadAheadIOContext::getStats() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+int ReadAheadIOContext::readCallback(void* opaque, uint8_t* buf, int buf_size) {
+	return static_cast<ReadAheadIOContext*>(opaque)->read(buf, buf_size);
+}
+
+int64_t ReadAheadIOContext::seekCallback(void* opaque, int64_t offset, int whence) {
+	return static_cast<ReadAheadIOContext*>(opaque)->seek(offset, whence);
+}
+
+int ReadAheadIOContext::read(uint8_t* buf, int buf_size) {
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (m_fill_pos > m_read_pos) {
+		m_stats.hits++;
+	}
+	else if (!m_eof && m_error == 0 && !m_abort.load()) {
+		// ѱգȴԤ߳
+		m_stats.misses++;
+		auto wait_start = std::chrono::steady_clock::now();
+		m_cond_reader.wait(lock, [this] {
+			return m_fill_pos > m_read_pos || m_eof || m_error != 0 || m_abort.load() || m_stop;
+			});
+		m_stats.miss_wait_us += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - wait_start).count());
+	}
+
+	if (m_abort.load()) {
+		return AVERROR_EXIT;
+	}
+	int64_t available = m_fill_pos - m_read_pos;
+	if (available <= 0) {
+		return m_error != 0 ? m_error : AVERROR_EOF;
+	}
+
+	// ӻλ帴ƣ (Խĩβʱ)
+	const size_t capacity = m_ring.size();
+	int copied = 0;
+	while (copied < buf_size && available > 0) {
+		size_t offset = static_cast<size_t>(m_read_pos % static_cast<int64_t>(capacity));
+		size_t n = std::min<size_t>({ static_cast<size_t>(buf_size - copied), static_cast<size_t>(available), capacity - offset });
+		memcpy(buf + copied, &m_ring[offset], n);
+		copied += static_cast<int>(n);
+		m_read_pos += n;
+		available -= n;
+	}
+	m_stats.bytes_read += copied;
+
+	// ڳ˿ռ䣬ѵȴеԤ߳
+	if (m_filler_waiting) {
+		m_cond_filler.notify_one();
+	}
+	return copied;
+}
+
+int64_t ReadAheadIOContext::seek(int64_t offset, int whence) {
+	if (whence & AVSEEK_SIZE) {
+		return m_file_size >= 0 ? m_file_size : AVERROR(ENOSYS);
+	}
+	whence &= ~AVSEEK_FORCE;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	int64_t target = 0;
+	switch (whence) {
+	case SEEK_SET:
+		target = offset;
+		break;
+	case SEEK_CUR:
+		target = m_read_pos + offset;
+		break;
+	case SEEK_END:
+		if (m_file_size < 0) {
+			return AVERROR(ENOSYS);
+		}
+		target = m_file_size + offset;
+		break;
+	default:
+		return AVERROR(EINVAL);
+	}
+	if (target < 0) {
+		return AVERROR(EINVAL);
+	}
+
+	// Ŀڻ崰 (Ѷ)ֻƶλ
+	if (target >= m_window_start && target <= m_fill_pos) {
+		m_read_pos = target;
+		m_stats.seeks_in_buffer++;
+		if (m_filler_waiting) {
+			m_cond_filler.notify_one();
+		}
+		return target;
+	}
+
+	if (!(m_outer->seekable & AVIO_SEEKABLE_NORMAL)) {
+		return AVERROR(ENOSYS);
+	}
+
+	// ⣺ʹʧЧԤִ߳еײ seek Ŀλ
+	m_generation++;
+	m_seek_target = target;
+	m_window_start = m_read_pos = m_fill_pos = target;
+	m_eof = false;
+	m_error = 0;
+	m_stats.seeks_refill++;
+	lock.unlock();
+	m_cond_filler.notify_one();
+	return target;
+}
+
+void ReadAheadIOContext::prefetchLoop() {
+	const int64_t capacity = static_cast<int64_t>(m_ring.size());
+	// λ֮ǰ m_back_reserve ֽڵѶݣռԤ
+	const int64_t ahead_limit = capacity - static_cast<int64_t>(m_back_reserve);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_stop) {
+		// 1. ִйĵײ seek
+		if (m_seek_target >= 0) {
+			int64_t target = m_seek_target;
+			uint64_t generation = m_generation;
+			m_seek_target = -1;
+			lock.unlock();
+			int64_t ret = avio_seek(m_inner, target, SEEK_SET);
+			lock.lock();
+			if (generation == m_generation && ret < 0) {
+				m_error = static_cast<int>(ret);
+				m_cond_reader.notify_all();
+			}
+			continue;
+		}
+
+		// 2. ѵβжϻԤʱȴ
+		int64_t ahead = m_fill_pos - m_read_pos;
+		if (m_eof || m_error != 0 || m_abort.load() || ahead >= ahead_limit) {
+			m_filler_waiting = true;
+			m_cond_filler.wait(lock);
+			m_filler_waiting = false;
+			continue;
+		}
+
+		// 3. ȡһ (Խĩβ)
+		int64_t write_pos = m_fill_pos;
+		size_t offset = static_cast<size_t>(write_pos % capacity);
+		size_t chunk = std::min<size_t>({ PREFETCH_CHUNK_SIZE, static_cast<size_t>(ahead_limit - ahead),
+			static_cast<size_t>(capacity) - offset });
+		// ǵƳ (Խλ֮ǰĲ)
+		if (write_pos + static_cast<int64_t>(chunk) - m_window_start > capacity) {
+			m_window_start = write_pos + static_cast<int64_t>(chunk) - capacity;
+		}
+		uint64_t generation = m_generation;
+		lock.unlock();
+
+		// ȡڼ䲻ڴڣװ̲߳
+		int n = avio_read_partial(m_inner, &m_ring[offset], static_cast<int>(chunk));
+
+		lock.lock();
+		if (generation != m_generation) {
+			continue; // ȡڼ仺ʧЧ
+		}
+		if (n > 0) {
+			m_fill_pos += n;
+			m_stats.bytes_prefetched += n;
+			m_cond_reader.notify_all();
+		}
+		else if (n == 0 || n == AVERROR_EOF) {
+			m_eof = true;
+			m_cond_reader.notify_all();
+		}
+		else if (!m_abort.load()) {
+			char errbuf[AV_ERROR_MAX_STRING_SIZE];
+			av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, n);
+			cerr << "ReadAheadIOContext: Prefetch read failed: " << errbuf << endl;
+			m_error = n;
+			m_cond_reader.notify_all();
+		}
+	}
+}
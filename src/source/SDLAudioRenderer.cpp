@@ -21,6 +21,7 @@
 #include "../include/SDLAudioRenderer.h"
 #include <stdexcept>
 #include <iostream>
+#include <cstring>  // memcpy
 
 extern "C" {
 #include <libavutil/error.h>
@@ -56,7 +57,7 @@ bool SDLAudioRenderer::init(int sampleRate, int channels, AVSampleFormat decoder
     wanted_spec.format = AUDIO_S16SYS;                  // ĿΪ16λзƵ
     wanted_spec.channels = channels > 2 ? 2 : channels; // Ϊ֧
     wanted_spec.silence = 0;
-    wanted_spec.samples = 1024;                         // ĻС
+    wanted_spec.samples = m_low_latency ? 512 : 1024;   // ĻСӳģʽ
     wanted_spec.callback = nullptr;                     // ʹPushģʽ (SDL_QueueAudio)
 
     // 2. Ƶ豸
@@ -73,34 +74,9 @@ bool SDLAudioRenderer::init(int sampleRate, int channels, AVSampleFormat decoder
     m_target_channels = m_actual_spec.channels;
 
     // 3. ǷҪز
-    if (decoderSampleFormat != m_target_sample_fmt || sampleRate != m_actual_spec.freq || channels != m_target_channels) {
-        std::cout << "SDLAudioRenderer: Audio resampling is required." << std::endl;
-        m_swr_context = swr_alloc();
-        if (!m_swr_context) {
-            std::cerr << "SDLAudioRenderer: Could not allocate resampler context." << std::endl;
-            close();
-            return false;
-        }
-
-        AVChannelLayout in_ch_layout, out_ch_layout;
-        av_channel_layout_default(&in_ch_layout, channels);
-        av_channel_layout_default(&out_ch_layout, m_target_channels);
-
-        av_opt_set_chlayout(m_swr_context, "in_chlayout", &in_ch_layout, 0);
-        av_opt_set_int(m_swr_context, "in_sample_rate", sampleRate, 0);
-        av_opt_set_sample_fmt(m_swr_context, "in_sample_fmt", decoderSampleFormat, 0);
-
-        av_opt_set_chlayout(m_swr_context, "out_chlayout", &out_ch_layout, 0);
-        av_opt_set_int(m_swr_context, "out_sample_rate", m_actual_spec.freq, 0);
-        av_opt_set_sample_fmt(m_swr_context, "out_sample_fmt", m_target_sample_fmt, 0);
-
-        if (swr_init(m_swr_context) < 0) {
-            std::cerr << "SDLAudioRenderer: Failed to initialize the resampling context." << std::endl;
-            close();
-            return false;
-        }
-        av_channel_layout_uninit(&in_ch_layout);
-        av_channel_layout_uninit(&out_ch_layout);
+    if (!configureResampler(sampleRate, channels, decoderSampleFormat)) {
+        close();
+        return false;
     }
 
     // 4. 㲢֪ͨʱӹƵӲ
@@ -115,57 +91,173 @@ bool SDLAudioRenderer::init(int sampleRate, int channels, AVSampleFormat decoder
 }
 
 bool SDLAudioRenderer::renderFrame(AVFrame* frame, const std::atomic<bool>& quit) {
-    if (!frame || !m_clock_manager || m_audio_device_id == 0) {
+    return renderFrames(&frame, 1, quit);
+}
+
+bool SDLAudioRenderer::ensureBufferSize(int size) {
+    if (size <= 0 || m_resampled_buffer_size >= static_cast<unsigned int>(size)) {
+        return true;
+    }
+    // av_realloc ᱣƴӵ
+    uint8_t* buffer = (uint8_t*)av_realloc(m_resampled_buffer, size);
+    if (!buffer) {
+        std::cerr << "SDLAudioRenderer: av_realloc for resample buffer failed" << std::endl;
+        return false;
+    }
+    m_resampled_buffer = buffer;
+    m_resampled_buffer_size = size;
+    return true;
+}
+
+bool SDLAudioRenderer::configureResampler(int sampleRate, int channels, AVSampleFormat sampleFormat) {
+    if (m_swr_context) {
+        swr_free(&m_swr_context);
+    }
+    m_in_sample_rate = sampleRate;
+    m_in_channels = channels;
+    m_in_sample_fmt = sampleFormat;
+
+    if (sampleFormat == m_target_sample_fmt && sampleRate == m_actual_spec.freq && channels == m_target_channels) {
+        return true;
+    }
+
+    std::cout << "SDLAudioRenderer: Audio resampling is required (" << sampleRate << " Hz, "
+        << channels << " channels, " << av_get_sample_fmt_name(sampleFormat) << ")." << std::endl;
+    m_swr_context = swr_alloc();
+    if (!m_swr_context) {
+        std::cerr << "SDLAudioRenderer: Could not allocate resampler context." << std::endl;
+        return false;
+    }
+
+    AVChannelLayout in_ch_layout, out_ch_layout;
+    av_channel_layout_default(&in_ch_layout, channels);
+    av_channel_layout_default(&out_ch_layout, m_target_channels);
+
+    av_opt_set_chlayout(m_swr_context, "in_chlayout", &in_ch_layout, 0);
+    av_opt_set_int(m_swr_context, "in_sample_rate", sampleRate, 0);
+    av_opt_set_sample_fmt(m_swr_context, "in_sample_fmt", sampleFormat, 0);
+
+    av_opt_set_chlayout(m_swr_context, "out_chlayout", &out_ch_layout, 0);
+    av_opt_set_int(m_swr_context, "out_sample_rate", m_actual_spec.freq, 0);
+    av_opt_set_sample_fmt(m_swr_context, "out_sample_fmt", m_target_sample_fmt, 0);
+
+    int ret = swr_init(m_swr_context);
+    av_channel_layout_uninit(&in_ch_layout);
+    av_channel_layout_uninit(&out_ch_layout);
+    if (ret < 0) {
+        std::cerr << "SDLAudioRenderer: Failed to initialize the resampling context." << std::endl;
+        swr_free(&m_swr_context);
+        return false;
+    }
+    return true;
+}
+
+bool SDLAudioRenderer::renderFrames(AVFrame** frames, int count, const std::atomic<bool>& quit) {
+    if (!frames || count <= 0 || !m_clock_manager || m_audio_device_id == 0) {
         return false;
     }
 
     uint8_t* audio_data = nullptr;
     int data_size = 0;
+    double last_pts = 0.0;  // һ֡ PTSڸƵʱ
 
-    if (m_swr_context) { // Ҫز
-        const int out_samples = swr_get_out_samples(m_swr_context, frame->nb_samples);
-        const int out_buffer_size = av_samples_get_buffer_size(NULL, m_target_channels, out_samples, m_target_sample_fmt, 1);
-        if (out_buffer_size < 0) {
-            std::cerr << "SDLAudioRenderer: av_samples_get_buffer_size() failed" << std::endl;
+    for (int i = 0; i < count; ++i) {
+        AVFrame* frame = frames[i];
+        if (!frame) {
             return false;
         }
 
-        if (m_resampled_buffer_size < out_buffer_size) {
-            av_freep(&m_resampled_buffer);
-            m_resampled_buffer = (uint8_t*)av_malloc(out_buffer_size);
-            if (!m_resampled_buffer) {
-                std::cerr << "SDLAudioRenderer: av_malloc for resample buffer failed" << std::endl;
+        // 仯 (лͬ)ز
+        if (frame->sample_rate != m_in_sample_rate || frame->ch_layout.nb_channels != m_in_channels ||
+            frame->format != m_in_sample_fmt) {
+            if (!configureResampler(frame->sample_rate, frame->ch_layout.nb_channels, (AVSampleFormat)frame->format)) {
                 return false;
             }
-            m_resampled_buffer_size = out_buffer_size;
         }
 
-        uint8_t* out_data[1] = { m_resampled_buffer };
-        int converted_samples = swr_convert(m_swr_context, out_data, out_samples,
-            (const uint8_t**)frame->data, frame->nb_samples);
-        if (converted_samples < 0) {
-            std::cerr << "SDLAudioRenderer: Error while converting audio." << std::endl;
-            return false;
+        if (m_swr_context) { // Ҫزƴӵز
+            const int out_samples = swr_get_out_samples(m_swr_context, frame->nb_samples);
+            const int out_buffer_size = av_samples_get_buffer_size(NULL, m_target_channels, out_samples, m_target_sample_fmt, 1);
+            if (out_buffer_size < 0) {
+                std::cerr << "SDLAudioRenderer: av_samples_get_buffer_size() failed" << std::endl;
+                return false;
+            }
+            if (!ensureBufferSize(data_size + out_buffer_size)) {
+                return false;
+            }
+
+            uint8_t* out_data[1] = { m_resampled_buffer + data_size };
+            int converted_samples = swr_convert(m_swr_context, out_data, out_samples,
+                (const uint8_t**)frame->data, frame->nb_samples);
+            if (converted_samples < 0) {
+                std::cerr << "SDLAudioRenderer: Error while converting audio." << std::endl;
+                return false;
+            }
+
+            audio_data = m_resampled_buffer;
+            data_size += converted_samples * m_target_channels * av_get_bytes_per_sample(m_target_sample_fmt);
+        }
+        else { // Ҫزֱʹԭʼ
+            int frame_size = av_samples_get_buffer_size(nullptr, frame->ch_layout.nb_channels, frame->nb_samples,
+                (AVSampleFormat)frame->format, 1);
+            if (frame_size < 0) {
+                std::cerr << "SDLAudioRenderer: av_samples_get_buffer_size() failed" << std::endl;
+                return false;
+            }
+            if (count == 1) {
+                // ֡ʱƴӣһο
+                audio_data = frame->data[0];
+                data_size = frame_size;
+            }
+            else {
+                if (!ensureBufferSize(data_size + frame_size)) {
+                    return false;
+                }
+                memcpy(m_resampled_buffer + data_size, frame->data[0], frame_size);
+                audio_data = m_resampled_buffer;
+                data_size += frame_size;
+            }
         }
 
-        audio_data = m_resampled_buffer;
-        data_size = converted_samples * m_target_channels * av_get_bytes_per_sample(m_target_sample_fmt);
-    }
-    else { // Ҫزֱʹԭʼ
-        audio_data = frame->data[0];
-        data_size = av_samples_get_buffer_size(nullptr, frame->ch_layout.nb_channels, frame->nb_samples,
-            (AVSampleFormat)frame->format, 1);
+        if (frame->pts != AV_NOPTS_VALUE) {
+            last_pts = frame->pts * av_q2d(m_time_base);
+        }
     }
 
-    // ؼݵSDL֮ǰõǰƵ֡ PTS Ƶʱ
-    double pts = (frame->pts == AV_NOPTS_VALUE) ? 0.0 : frame->pts * av_q2d(m_time_base);
-    if (pts != 0.0) {
-        m_clock_manager->setAudioClock(pts);
+    // ٲزΪ豸ʽͳһ atempo 
+    // (˾ڲļʮδ豸УƵʱӻӦ΢ǰ)
+    if (m_tempo_reset_pending.exchange(false)) {
+        m_tempo_filter.close();
+    }
+    const double rate = m_playback_rate.load();
+    if (rate != 1.0 && !m_tempo_filter.isInitialized() && !m_tempo_unavailable) {
+        if (!m_tempo_filter.init(m_actual_spec.freq, m_target_channels, m_target_sample_fmt, rate)) {
+            m_tempo_unavailable = true; // ޷ʱʼհԭٲţÿ
+        }
+    }
+    if (m_tempo_filter.isInitialized() && data_size > 0) {
+        if (rate != m_tempo_filter.getTempo()) {
+            m_tempo_filter.setTempo(rate);
+        }
+        const int bytes_per_sample_frame = m_target_channels * av_get_bytes_per_sample(m_target_sample_fmt);
+        m_tempo_buffer.clear();
+        if (m_tempo_filter.process(audio_data, data_size / bytes_per_sample_frame, m_tempo_buffer)) {
+            audio_data = m_tempo_buffer.data();
+            data_size = static_cast<int>(m_tempo_buffer.size());
+        }
+        else {
+            // ˾˾ԭٲ
+            std::cerr << "SDLAudioRenderer: Tempo filter failed, falling back to normal speed." << std::endl;
+            m_tempo_filter.close();
+            m_tempo_unavailable = true;
+        }
     }
 
     // ƣSDLеݹࣨ糬1.5룩ȴ
     // ԷֹڴģܸӦתseek
-    const Uint32 max_queued_size = m_bytes_per_second * 1.5;
+    // ӳģʽֻѹʮ룬֡
+    const Uint32 max_queued_size = static_cast<Uint32>(m_bytes_per_second *
+        (m_low_latency ? LOW_LATENCY_MAX_QUEUED_SEC : MAX_QUEUED_SEC));
     while (SDL_GetQueuedAudioSize(m_audio_device_id) > max_queued_size) {
         // ڵȴʱ˳־
         if (quit) {
@@ -175,12 +267,18 @@ bool SDLAudioRenderer::renderFrame(AVFrame* frame, const std::atomic<bool>& quit
         SDL_Delay(10);
     }
 
-    // յPCM͵SDLĲŶ
-    if (SDL_QueueAudio(m_audio_device_id, audio_data, data_size) < 0) {
+    // PCMһ͵SDLĲŶ
+    if (data_size > 0 && SDL_QueueAudio(m_audio_device_id, audio_data, data_size) < 0) {
         std::cerr << "SDLAudioRenderer: Failed to queue audio: " << SDL_GetError() << std::endl;
         return false;
     }
 
+    // ؼݽSDL֮һ֡ PTS Ƶʱ
+    // (ʱӰ PTS ȥдݼ㣬ȸ»ʱǰݳǰһ)
+    if (last_pts != 0.0) {
+        m_clock_manager->setAudioClock(last_pts);
+    }
+
     return true;
 }
 
@@ -199,10 +297,21 @@ void SDLAudioRenderer::pause() {
 void SDLAudioRenderer::flushBuffers() {
     if (m_audio_device_id != 0) {
         SDL_ClearQueuedAudio(m_audio_device_id);
+        m_tempo_reset_pending = true; // ˾Ⱦ߳һǰ
         std::cout << "SDLAudioRenderer: Audio device buffer flushed." << std::endl;
     }
 }
 
+void SDLAudioRenderer::setPlaybackRate(double rate) {
+    if (rate > 0.0) {
+        m_playback_rate = rate;
+    }
+}
+
+void SDLAudioRenderer::setLowLatency(bool enable) {
+    m_low_latency = enable;
+}
+
 void SDLAudioRenderer::close() {
     if (m_audio_device_id != 0) {
         SDL_PauseAudioDevice(m_audio_device_id, 1);
@@ -213,6 +322,7 @@ void SDLAudioRenderer::close() {
     if (m_swr_context) {
         swr_free(&m_swr_context);
     }
+    m_tempo_filter.close();
     if (m_resampled_buffer) {
         av_freep(&m_resampled_buffer);
         m_resampled_buffer_size = 0;
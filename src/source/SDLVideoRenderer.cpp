@@ -21,6 +21,7 @@
 #include "../include/SDLVideoRenderer.h"
 #include <algorithm> // std::max
 #include <iostream>
+#include <chrono>    // std::chrono::milliseconds
 
 SDLVideoRenderer::~SDLVideoRenderer() {
     close();
@@ -69,37 +70,45 @@ bool SDLVideoRenderer::init(const char* windowTitle, int width, int height,
         return true;
     }
 
-    // Texture ߴ̶ΪƵԭʼֱ
-    m_texture = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_IYUV, SDL_TEXTUREACCESS_STREAMING,
-                                m_video_width, m_video_height);
-    if (!m_texture) {
-        std::cerr << "Texture could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
+    // Texture ߴ̶ΪƵԭʼֱʣ front/back
+    // Ϊ NV12/NV21 ʱʹͬʽƽֱϴʽʹ I420 
+    if (m_decoder_pixel_format == AV_PIX_FMT_NV12 || m_decoder_pixel_format == AV_PIX_FMT_NV21) {
+        Uint32 nvFormat = (m_decoder_pixel_format == AV_PIX_FMT_NV12) ? SDL_PIXELFORMAT_NV12 : SDL_PIXELFORMAT_NV21;
+        m_slots[0].texture = createTexture(nvFormat);
+        m_slots[1].texture = createTexture(nvFormat);
+        if (m_slots[0].texture && m_slots[1].texture) {
+            m_texture_format = m_decoder_pixel_format;
+        }
+        else {
+            std::cerr << "SDLVideoRenderer: NV texture not supported (" << SDL_GetError() << "), falling back to I420." << std::endl;
+            for (TextureSlot& slot : m_slots) {
+                if (slot.texture) {
+                    SDL_DestroyTexture(slot.texture);
+                    slot.texture = nullptr;
+                }
+            }
+        }
     }
-
-    // SwsContext ֻɫת
-    m_sws_context = sws_getContext(m_video_width, m_video_height, m_decoder_pixel_format,
-                                m_video_width, m_video_height, AV_PIX_FMT_YUV420P,
-                                SWS_BILINEAR, nullptr, nullptr, nullptr);
-    if (!m_sws_context) {
-        std::cerr << "Could not create SwsContext" << std::endl;
+    if (!m_slots[0].texture) {
+        m_slots[0].texture = createTexture(SDL_PIXELFORMAT_IYUV);
+        m_slots[1].texture = createTexture(SDL_PIXELFORMAT_IYUV);
+        m_texture_format = AV_PIX_FMT_YUV420P;
+    }
+    if (!m_slots[0].texture || !m_slots[1].texture) {
+        std::cerr << "Texture could not be created! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
     }
 
-    // Ϊ YUV ݷڴ
-    m_yuv_frame = av_frame_alloc();
-    if (!m_yuv_frame) return false;
-    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_YUV420P, m_video_width, m_video_height, 1);
-    uint8_t* buffer = (uint8_t*)av_malloc(numBytes * sizeof(uint8_t));
-    av_image_fill_arrays(m_yuv_frame->data, m_yuv_frame->linesize, buffer, AV_PIX_FMT_YUV420P,
-                        m_video_width, m_video_height, 1);
-
-    // ڱһ֡ AVFrame
-    m_last_rendered_frame = av_frame_alloc();
-    if (!m_last_rendered_frame) {
-        std::cerr << "Could not allocate last rendered frame." << std::endl;
-        return false;
+    // ʽͬԴֻ֡ãϴʱֱʹýƽ棻
+    // ʽڵһʱŴ SwsContextֱ֮תĺ̨
+    for (TextureSlot& slot : m_slots) {
+        slot.direct = av_frame_alloc();
+        if (!slot.direct) return false;
     }
+    m_default_yuv_mode = SDL_GetYUVConversionMode();
+    m_front = 0;
+    m_slots[0].state = SlotState::MAIN;
+    m_slots[1].state = SlotState::FREE;
 
     // ʼ OSD
     m_osd_layer = std::make_unique<OSDLayer>();
@@ -139,7 +148,7 @@ void SDLVideoRenderer::renderOSD() {
 }
 
 // ڹִ߳
-double SDLVideoRenderer::calculateSyncDelay(AVFrame* frame) {
+double SDLVideoRenderer::calculateSyncDelay(AVFrame* frame, const AVFrame* next_frame) {
     if (!frame || !m_clock_manager) return 0.0;
 
     // 1. 㵱ǰ֡PTS
@@ -154,7 +163,20 @@ double SDLVideoRenderer::calculateSyncDelay(AVFrame* frame) {
     }
 
     //  duration
-    double duration = (frame->duration > 0) ? (frame->duration * av_q2d(m_time_base)) : m_frame_last_duration;
+    // ʹһ֡ PTS ֵ (ʵ֡)֡Դ durationһ֡Ĺֵ
+    double duration = 0.0;
+    bool has_real_duration = false;
+    if (next_frame && frame->pts != AV_NOPTS_VALUE && next_frame->pts != AV_NOPTS_VALUE) {
+        double next_duration = (next_frame->pts - frame->pts) * av_q2d(m_time_base);
+        // ųʱ (ơ) ɵ쳣ֵ
+        if (next_duration > 0.0 && next_duration < MAX_FRAME_DURATION) {
+            duration = next_duration;
+            has_real_duration = true;
+        }
+    }
+    if (!has_real_duration) {
+        duration = (frame->duration > 0) ? (frame->duration * av_q2d(m_time_base)) : m_frame_last_duration;
+    }
 
     // һ֡ϢһѭĹ
     m_frame_last_pts = pts;
@@ -237,6 +259,11 @@ double SDLVideoRenderer::calculateSyncDelay(AVFrame* frame) {
         }
     }
 
+    // һ֡Ҳѵڣ֡ʾڶѹڣֱӶ
+    if (has_real_duration && delay < -duration) {
+        return SYNC_SIGNAL_DROP_FRAME;
+    }
+
     // Ƶ֡
     if (delay < -AV_SYNC_THRESHOLD_MAX) {
         // һźţ֪ͨ߶֡
@@ -263,43 +290,239 @@ double SDLVideoRenderer::calculateSyncDelay(AVFrame* frame) {
     return delay;
 }
 
+SDL_Texture* SDLVideoRenderer::createTexture(Uint32 format) {
+    return SDL_CreateTexture(m_renderer, format, SDL_TEXTUREACCESS_STREAMING, m_video_width, m_video_height);
+}
+
+bool SDLVideoRenderer::canUploadDirectly(const AVFrame* frame) const {
+    // YUVJ420P (MJPEG)  YUV420P ƽ沼ֻͬɫʷΧͬ
+    // ֱϴ I420 ʾʱ SDL  JPEG (ȫΧ) תģʽ
+    bool same_layout = frame->format == m_texture_format ||
+        (m_texture_format == AV_PIX_FMT_YUV420P && frame->format == AV_PIX_FMT_YUVJ420P);
+    if (!same_layout || frame->width != m_video_width || frame->height != m_video_height) {
+        return false;
+    }
+    // SDL ϴӿڲܸп (ô洢֡)
+    int planes = (m_texture_format == AV_PIX_FMT_YUV420P) ? 3 : 2;
+    for (int i = 0; i < planes; i++) {
+        if (!frame->data[i] || frame->linesize[i] <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SDLVideoRenderer::convertFrame(const AVFrame* frame, TextureSlot& slot) {
+    // Դʽߴڲб仯ʱgetCachedContext ؽģ̶Ϊĸʽߴ
+    m_sws_context = sws_getCachedContext(m_sws_context, frame->width, frame->height, (enum AVPixelFormat)frame->format,
+                                        m_video_width, m_video_height, m_texture_format,
+                                        SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!m_sws_context) {
+        std::cerr << "Could not create SwsContext" << std::endl;
+        return false;
+    }
+
+    uint8_t* dst_data[4] = { nullptr };
+    int dst_linesize[4] = { 0 };
+    if (slot.locked) {
+        // ֱдڴ棺SDL  YUV  Y ƽ pitch иƽ棬
+        // I420  U/V ƽ pitch 룬NV12/NV21  UV ƽ pitch  Y ƽͬ (ȡż)
+        int chroma_pitch = (slot.pitch + 1) / 2;
+        dst_data[0] = static_cast<uint8_t*>(slot.pixels);
+        dst_linesize[0] = slot.pitch;
+        dst_data[1] = dst_data[0] + slot.pitch * m_video_height;
+        if (m_texture_format == AV_PIX_FMT_YUV420P) {
+            dst_linesize[1] = chroma_pitch;
+            dst_data[2] = dst_data[1] + chroma_pitch * ((m_video_height + 1) / 2);
+            dst_linesize[2] = chroma_pitch;
+        }
+        else {
+            dst_linesize[1] = chroma_pitch * 2;
+        }
+        slot.source = SlotSource::LOCKED;
+    }
+    else {
+        // δ (մֱϴлת)ת壬߳̿ϴ
+        if (!slot.buffer) {
+            slot.buffer = av_frame_alloc();
+            if (!slot.buffer) return false;
+            slot.buffer->format = m_texture_format;
+            slot.buffer->width = m_video_width;
+            slot.buffer->height = m_video_height;
+            if (av_frame_get_buffer(slot.buffer, 0) < 0) {
+                av_frame_free(&slot.buffer);
+                return false;
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            dst_data[i] = slot.buffer->data[i];
+            dst_linesize[i] = slot.buffer->linesize[i];
+        }
+        slot.source = SlotSource::BUFFER;
+    }
+
+    sws_scale(m_sws_context, (const uint8_t* const*)frame->data, frame->linesize,
+            0, frame->height, dst_data, dst_linesize);
+    return true;
+}
+
+void SDLVideoRenderer::applyYUVConversionMode(const TextureSlot& slot) {
+    // SDL  YUV תģʽȫãڻʱЧ
+    SDL_YUV_CONVERSION_MODE mode = slot.full_range ? SDL_YUV_CONVERSION_JPEG : m_default_yuv_mode;
+    if (SDL_GetYUVConversionMode() != mode) {
+        SDL_SetYUVConversionMode(mode);
+    }
+}
+
+int SDLVideoRenderer::uploadSlot(TextureSlot& slot) {
+    AVFrame* data = (slot.source == SlotSource::DIRECT) ? slot.direct :
+                    (slot.source == SlotSource::BUFFER) ? slot.buffer : nullptr;
+    if (!data) return -1;
+
+    if (m_texture_format == AV_PIX_FMT_YUV420P) {
+        return SDL_UpdateYUVTexture(slot.texture, nullptr,
+                                    data->data[0], data->linesize[0],
+                                    data->data[1], data->linesize[1],
+                                    data->data[2], data->linesize[2]);
+    }
+    return SDL_UpdateNVTexture(slot.texture, nullptr,
+                               data->data[0], data->linesize[0],
+                               data->data[1], data->linesize[1]);
+}
+
 // ڹִ߳
 bool SDLVideoRenderer::prepareFrameForDisplay(AVFrame* frame) {
     if (m_is_audio_only || !frame) return false;
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (!m_sws_context || !m_yuv_frame) return false;
+    bool direct = canUploadDirectly(frame);
+    if (frame->format != m_last_source_format) {
+        m_last_source_format = frame->format;
+        const char* name = av_get_pix_fmt_name((enum AVPixelFormat)frame->format);
+        std::cout << "SDLVideoRenderer: Source format " << (name ? name : "unknown")
+            << (direct ? ", uploading decoder planes directly." : ", converting into the locked texture.") << std::endl;
+    }
+    // Ҫתʱ߳ڽԤһ̨
+    m_convert_active = !direct;
+
+    // ȡų́λУ䵫̻߳ûüʾ (øµ֡)
+    // ֻ߳ڽ˲ռų́λֻȴһСʱ䣬תϴ
+    TextureSlot* slot = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(m_swap_mutex);
+        bool acquired = m_swap_cond.wait_for(lock, std::chrono::milliseconds(SLOT_WAIT_TIMEOUT_MS), [this] {
+            SlotState state = m_slots[1 - m_front].state;
+            return state == SlotState::FREE || state == SlotState::READY;
+            });
+        if (!acquired || !m_slots[1 - m_front].direct) {
+            return false;
+        }
+        slot = &m_slots[1 - m_front];
+        if (slot->state == SlotState::READY) {
+            // һ֡û߳ȡ߾ͱǣᱻʾΪ֡
+            m_overwritten_frames++;
+        }
+        slot->state = SlotState::FILLING;
+    }
+
+    // ͷŸòλһ֡
+    av_frame_unref(slot->direct);
+    slot->source = SlotSource::NONE;
 
-    // һ֡ãڴڳߴػ
-    av_frame_unref(m_last_rendered_frame); // ͷžɵ
-    if (av_frame_ref(m_last_rendered_frame, frame) < 0) {
-        std::cerr << "SDLVideoRenderer: Failed to reference last frame." << std::endl;
-        // 󣬿Լ
+    bool ok;
+    if (direct) {
+        // ʽԴֻ֡ͬüֱ߳ӴӽƽϴתͿ
+        ok = av_frame_ref(slot->direct, frame) >= 0;
+        if (ok) {
+            slot->source = SlotSource::DIRECT;
+            slot->full_range = frame->format == AV_PIX_FMT_YUVJ420P || frame->color_range == AVCOL_RANGE_JPEG;
+        }
+    }
+    else {
+        // ֻɫʿռת (ĿߴƵԭʼߴ)ֱд̨swscale ޷Χ
+        ok = convertFrame(frame, *slot);
+        slot->full_range = false;
     }
 
-    // ֻɫʿռת׼ YUV  (ԴĿߴ綼Ƶԭʼߴ)
-    sws_scale(m_sws_context, (const uint8_t* const*)frame->data, frame->linesize,
-            0, m_video_height, m_yuv_frame->data, m_yuv_frame->linesize);
+    {
+        std::lock_guard<std::mutex> lock(m_swap_mutex);
+        slot->state = ok ? SlotState::READY : SlotState::FREE;
+    }
+    return ok;
+}
+
+bool SDLVideoRenderer::swapInReadySlot() {
+    int back;
+    {
+        std::lock_guard<std::mutex> lock(m_swap_mutex);
+        back = 1 - m_front;
+        if (m_slots[back].state != SlotState::READY) {
+            return false;
+        }
+        m_slots[back].state = SlotState::CONSUMING;
+    }
 
+    TextureSlot& slot = m_slots[back];
+    // ڴ漴Ϊϴݣʱ SDL ϴ
+    // ԴȽܸ (תлֱϴʱ)
+    if (slot.locked) {
+        SDL_UnlockTexture(slot.texture);
+        slot.locked = false;
+        slot.pixels = nullptr;
+    }
+    if (slot.source != SlotSource::LOCKED) {
+        uploadSlot(slot);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_swap_mutex);
+        slot.state = SlotState::MAIN;
+        m_slots[m_front].state = SlotState::MAIN;   // ɵ front Ϊ̨λ׼úٽ߳
+        m_front = back;
+    }
+    m_has_frame = true;
     return true;
 }
 
+void SDLVideoRenderer::releaseBackSlot() {
+    TextureSlot& slot = m_slots[1 - m_front];
+    {
+        std::lock_guard<std::mutex> lock(m_swap_mutex);
+        if (slot.state != SlotState::MAIN) {
+            return;
+        }
+    }
+    // ҪתʱԤֱ߳תڴУʡȥһ֡
+    if (m_convert_active && !slot.locked && slot.texture) {
+        if (SDL_LockTexture(slot.texture, nullptr, &slot.pixels, &slot.pitch) == 0) {
+            slot.locked = true;
+        }
+        else {
+            std::cerr << "SDLVideoRenderer: SDL_LockTexture failed (" << SDL_GetError() << "), converting into a buffer." << std::endl;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_swap_mutex);
+        slot.state = SlotState::FREE;
+    }
+    m_swap_cond.notify_all();
+}
+
 // ʾƵִ֡߳
 void SDLVideoRenderer::displayFrame() {
     std::lock_guard<std::mutex> lock(m_mutex);
-    if (m_is_audio_only || !m_renderer || !m_texture || !m_yuv_frame) return;
+    if (m_is_audio_only || !m_renderer || !m_slots[0].texture) return;
 
-    // ʹ׼õ YUV ݸ
-    SDL_UpdateYUVTexture(m_texture, nullptr,
-                        m_yuv_frame->data[0], m_yuv_frame->linesize[0],
-                        m_yuv_frame->data[1], m_yuv_frame->linesize[1],
-                        m_yuv_frame->data[2], m_yuv_frame->linesize[2]);
+    // ȡ߹߳׼õĺ̨һ߳
+    swapInReadySlot();
+    releaseBackSlot();
+    if (!m_has_frame) return;
 
     // Ⱦ
     SDL_RenderClear(m_renderer);
     // ʾľΣGPU RenderCopy() ʱ
     SDL_Rect displayRect = calculateDisplayRect(m_window_width, m_window_height);
-    SDL_RenderCopy(m_renderer, m_texture, nullptr, &displayRect);
+    applyYUVConversionMode(m_slots[m_front]);
+    SDL_RenderCopy(m_renderer, m_slots[m_front].texture, nullptr, &displayRect);
 
     // Ⱦ֡
     if (m_debug_stats) {
@@ -325,7 +548,7 @@ void SDLVideoRenderer::refresh() {
     // Ƶģʽ
     else {
         // ûЧһֻ֡
-        if (!m_last_rendered_frame || m_last_rendered_frame->width == 0) {
+        if (!m_has_frame) {
             SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
             SDL_RenderClear(m_renderer);
         }
@@ -338,25 +561,21 @@ void SDLVideoRenderer::refresh() {
             SDL_Rect displayRect = calculateDisplayRect(m_window_width, m_window_height);
 
             // е
-            int ret = SDL_RenderCopy(m_renderer, m_texture, nullptr, &displayRect);
+            TextureSlot& front = m_slots[m_front];
+            applyYUVConversionMode(front);
+            int ret = SDL_RenderCopy(m_renderer, front.texture, nullptr, &displayRect);
 
             // ʧܣ٣ĶʧԻָݲػ
             if (ret < 0) {
                 std::cerr << "SDLVideoRenderer: RenderCopy failed (" << SDL_GetError() << "), attempting to reload texture..." << std::endl;
 
-                if (m_yuv_frame && m_sws_context && m_last_rendered_frame) {
-                    // ½иʽת
-                    sws_scale(m_sws_context, (const uint8_t* const*)m_last_rendered_frame->data, m_last_rendered_frame->linesize,
-                        0, m_video_height, m_yuv_frame->data, m_yuv_frame->linesize);
-
-                    // ϴݵ
-                    SDL_UpdateYUVTexture(m_texture, nullptr,
-                        m_yuv_frame->data[0], m_yuv_frame->linesize[0],
-                        m_yuv_frame->data[1], m_yuv_frame->linesize[1],
-                        m_yuv_frame->data[2], m_yuv_frame->linesize[2]);
+                // ֱдڴ֡û CPU ˵ĸֻܵһ֡
+                if (front.source == SlotSource::DIRECT || front.source == SlotSource::BUFFER) {
+                    // û֡ϴ
+                    uploadSlot(front);
 
                     // ݻָ󣬱ٴε RenderCopy
-                    if (SDL_RenderCopy(m_renderer, m_texture, nullptr, &displayRect) < 0) {
+                    if (SDL_RenderCopy(m_renderer, front.texture, nullptr, &displayRect) < 0) {
                         std::cerr << "SDLVideoRenderer: Recovery failed. Texture might be invalid." << std::endl;
                     }
                 }
@@ -372,23 +591,30 @@ void SDLVideoRenderer::refresh() {
 void SDLVideoRenderer::close() {
     std::lock_guard<std::mutex> lock(m_mutex);  // 
 
-    if (m_yuv_frame) {
-        av_freep(&m_yuv_frame->data[0]); // ͷ av_image_fill_arrays  buffer
-        av_frame_free(&m_yuv_frame);
-        m_yuv_frame = nullptr;
+    {
+        std::lock_guard<std::mutex> swap_lock(m_swap_mutex);
+        for (TextureSlot& slot : m_slots) {
+            if (slot.locked) {
+                SDL_UnlockTexture(slot.texture);
+                slot.locked = false;
+                slot.pixels = nullptr;
+            }
+            if (slot.texture) {
+                SDL_DestroyTexture(slot.texture);
+                slot.texture = nullptr;
+            }
+            av_frame_free(&slot.direct);  // ͬʱͷŶԽ֡
+            av_frame_free(&slot.buffer);
+            slot.source = SlotSource::NONE;
+            slot.state = SlotState::MAIN;  // ̲߳ȡòλ
+        }
     }
+    m_last_source_format = AV_PIX_FMT_NONE;
     if (m_sws_context) {
         sws_freeContext(m_sws_context);
         m_sws_context = nullptr;
     }
-    if (m_last_rendered_frame) {
-        av_frame_free(&m_last_rendered_frame);
-        m_last_rendered_frame = nullptr;
-    }
-    if (m_texture) {
-        SDL_DestroyTexture(m_texture);
-        m_texture = nullptr;
-    }
+    m_has_frame = false;
     if (m_renderer) {
         SDL_DestroyRenderer(m_renderer);
         m_renderer = nullptr;
@@ -445,12 +671,18 @@ void SDLVideoRenderer::setStreamType(bool isLive) {
     m_is_live_stream = isLive; 
 }
 
+// ڹִ߳УЩ״ֻ̬ɹ̷߳ʣ߳ͬ
 void SDLVideoRenderer::flush() {
-    std::lock_guard<std::mutex> lock(m_mutex);
     // һ֡ PTS ¼ֹ PTS 
     m_frame_last_pts = 0.0;
     m_frame_last_duration = DEFAULT_FRAME_DURATION;
     //  reset ״̬
     m_first_frame_after_reset = true;
     std::cout << "SDLVideoRenderer: Flushed internal state." << std::endl;
-}
\ No newline at end of file
+}
+
+unsigned int SDLVideoRenderer::takeOverwrittenFrames() {
+    unsigned int count = m_overwritten_frames;
+    m_overwritten_frames = 0;
+    return count;
+}
@@ -0,0 +1,124 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/StreamPacketBuffer.h"
+#include <chrono>
+
+using namespace std;
+
+StreamPacketBuffer::StreamPacketBuffer(size_t max_total_bytes)
+	: m_max_total_bytes(max_total_bytes) {}
+
+void StreamPacketBuffer::addStream(int stream_index, PacketQueue* queue) {
+	if (stream_index < 0 || !queue) {
+		return;
+	}
+	queue->setSoftBudget(true);
+	m_streams.push_back({ stream_index, queue });
+}
+
+PacketQueue* StreamPacketBuffer::getStream(int stream_index) const {
+	for (const StreamView& view : m_streams) {
+		if (view.stream_index == stream_index) {
+			return view.queue;
+		}
+	}
+	return nullptr;
+}
+
+bool StreamPacketBuffer::remapStream(int old_stream_index, int new_stream_index) {
+	for (StreamView& view : m_streams) {
+		if (view.stream_index == old_stream_index) {
+			view.stream_index = new_stream_index;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool StreamPacketBuffer::push(AVPacket*&& packet, int serial) {
+	if (!packet) {
+		return false;
+	}
+	PacketQueue* queue = getStream(packet->stream_index);
+	if (!queue) {
+		return false;
+	}
+	return queue->push(std::move(packet), serial);
+}
+
+bool StreamPacketBuffer::isEnough() const {
+	if (m_streams.empty()) {
+		return false;
+	}
+
+	// ֻҪһ·ԭϾͱȡ
+	bool all_enough = true;
+	for (const StreamView& view : m_streams) {
+		if (!view.queue->hasEnoughPackets()) {
+			all_enough = false;
+			break;
+		}
+	}
+	if (all_enough) {
+		return true;
+	}
+
+	// ףֹĳһ·ٳٴﲻ㹻ʱһ·Ƶ
+	// һ·ͻ (֯ļ)ͣȡգʱȡ
+	// ѻ϶һ·ֻԼĻ
+	if (m_max_total_bytes == 0 || getTotalBytes() <= m_max_total_bytes) {
+		return false;
+	}
+	for (const StreamView& view : m_streams) {
+		if (!view.queue->hasMinimumPackets(MIN_PACKETS)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool StreamPacketBuffer::waitWhileEnough(int timeout_ms) {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cond_reader.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] {
+		return m_abort_request.load() || !isEnough();
+		});
+	return !m_abort_request.load();
+}
+
+void StreamPacketBuffer::wake() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_cond_reader.notify_all();
+}
+
+void StreamPacketBuffer::abort() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_abort_request.store(true);
+	lock.unlock();
+	m_cond_reader.notify_all();
+}
+
+size_t StreamPacketBuffer::getTotalBytes() const {
+	size_t total = 0;
+	for (const StreamView& view : m_streams) {
+		total += view.queue->getTotalBytes();
+	}
+	return total;
+}
@@ -0,0 +1,384 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/StreamRecorder.h"
+#include <iostream>
+#include <cstdio>
+#include <ctime>
+
+extern "C" {
+#include <libavutil/error.h>
+#include <libavutil/mathematics.h>
+}
+
+using namespace std;
+
+StreamRecorder::StreamRecorder(const string& format, const string& path_prefix, double segment_sec, size_t max_queue_bytes)
+	: m_format(format), m_path_prefix(path_prefix), m_segment_sec(segment_sec), m_max_queue_bytes(max_queue_bytes) {
+}
+
+StreamRecorder::~StreamRecorder() {
+	joinWriter();
+}
+
+bool StreamRecorder::start(const AVFormatContext* input, const vector<int>& stream_indices, int key_stream) {
+	// һ¼Ƶд߳дʣݣڵ߳ (װ߳) еȴɵԺ
+	if (isFlushing()) {
+		return false;
+	}
+	// д߳ѽ
+	joinWriter();
+	if (!input || stream_indices.empty()) {
+		return false;
+	}
+
+	for (int index : stream_indices) {
+		if (index < 0 || index >= static_cast<int>(input->nb_streams)) continue;
+		const AVStream* st = input->streams[index];
+		AVCodecParameters* par = avcodec_parameters_alloc();
+		if (!par || avcodec_parameters_copy(par, st->codecpar) < 0) {
+			avcodec_parameters_free(&par);
+			continue;
+		}
+		m_streams.push_back(OutputStream{ index, par, st->time_base });
+	}
+	if (m_streams.empty()) {
+		cerr << "StreamRecorder: No stream to record." << endl;
+		return false;
+	}
+	m_key_stream = key_stream;
+	m_ts_offsets.assign(m_streams.size(), 0);
+
+	// ļ壺ǰ׺ + ʼʱ
+	char stamp[32] = { 0 };
+	time_t now = time(nullptr);
+	strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", localtime(&now));
+	m_file_stem = m_path_prefix + stamp;
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_queue.clear();
+		m_queued_bytes = 0;
+		m_skip_to_keyframe = true;
+		m_waiting_first_keyframe = true;
+		m_discontinuity = false;
+		m_stop = false;
+		m_writer_done = false;
+		m_stats = RecorderStats();
+		m_stats.recording = true;
+	}
+	m_write_error_logged = false;
+	m_thread = std::thread(&StreamRecorder::writeLoop, this);
+
+	cout << "StreamRecorder: Recording " << m_streams.size() << " stream(s) to " << m_file_stem
+		<< "_NNN (" << m_format << ", " << m_segment_sec << "s segments)." << endl;
+	return true;
+}
+
+void StreamRecorder::stop() {
+	{
+		lock_guard<mutex> lock(m_mutex);
+		if (!m_stats.recording) return;
+		m_stats.recording = false;
+		m_stop = true;
+	}
+	m_cond.notify_all();
+	cout << "StreamRecorder: Stop requested, flushing queued packets." << endl;
+}
+
+bool StreamRecorder::isRecording() const {
+	lock_guard<mutex> lock(m_mutex);
+	return m_stats.recording;
+}
+
+bool StreamRecorder::isFlushing() const {
+	if (!m_thread.joinable()) {
+		return false;
+	}
+	lock_guard<mutex> lock(m_mutex);
+	return !m_stats.recording && !m_writer_done;
+}
+
+void StreamRecorder::submit(const AVPacket* packet, bool keyframe) {
+	if (!packet) return;
+
+	// ¼ڼ m_streams 䣬ֻнװ̻߳޸
+	bool tracked = false;
+	for (const OutputStream& s : m_streams) {
+		if (s.input_index == packet->stream_index) {
+			tracked = true;
+			break;
+		}
+	}
+	if (!tracked) return;
+
+	bool is_key = keyframe && packet->stream_index == m_key_stream;
+	size_t size = static_cast<size_t>(packet->size);
+	bool gap_started = false;
+	size_t queued_kb = 0;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		if (!m_stats.recording) return;
+
+		if (m_skip_to_keyframe && !is_key) {
+			if (!m_waiting_first_keyframe) {
+				m_stats.packets_dropped++;
+			}
+			return;
+		}
+		if (!m_queue.empty() && m_queued_bytes + size > m_max_queue_bytes) {
+			// дϣһؼ֡Ϊֹ GOP ļŲӰ
+			if (!m_skip_to_keyframe) {
+				m_stats.gaps++;
+				gap_started = true;
+				queued_kb = m_queued_bytes >> 10;
+			}
+			m_skip_to_keyframe = true;
+			m_waiting_first_keyframe = false;
+			m_stats.packets_dropped++;
+		}
+		else {
+			AVPacket* ref = av_packet_alloc();
+			if (!ref || av_packet_ref(ref, packet) < 0) {
+				av_packet_free(&ref);
+				m_stats.packets_dropped++;
+				return;
+			}
+			m_skip_to_keyframe = false;
+			m_waiting_first_keyframe = false;
+			m_queue.push_back(QueuedPacket{ ref, is_key, is_key && m_discontinuity });
+			if (is_key) {
+				m_discontinuity = false;
+			}
+			m_queued_bytes += size;
+			m_stats.queued_bytes = m_queued_bytes;
+		}
+	}
+
+	if (gap_started) {
+		cerr << "StreamRecorder Warning: Writer is falling behind (" << queued_kb
+			<< " KB queued), dropping packets until the next keyframe." << endl;
+		return;
+	}
+	m_cond.notify_one();
+}
+
+void StreamRecorder::markDiscontinuity() {
+	lock_guard<mutex> lock(m_mutex);
+	if (!m_stats.recording) return;
+	m_skip_to_keyframe = true;
+	m_waiting_first_keyframe = true;
+	m_discontinuity = true;
+}
+
+RecorderStats StreamRecorder::getStats() const {
+	lock_guard<mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void StreamRecorder::writeLoop() {
+	while (true) {
+		QueuedPacket item{ nullptr, false, false };
+		{
+			unique_lock<mutex> lock(m_mutex);
+			m_cond.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+			if (m_queue.empty()) {
+				break; // ֹͣҶд
+			}
+			item = m_queue.front();
+			m_queue.pop_front();
+			m_queued_bytes -= static_cast<size_t>(item.packet->size);
+			m_stats.queued_bytes = m_queued_bytes;
+		}
+
+		AVPacket* packet = item.packet;
+		size_t output_index = 0;
+		while (output_index < m_streams.size() && m_streams[output_index].input_index != packet->stream_index) {
+			output_index++;
+		}
+
+		// ֶΣֶʱжϺ key_stream һؼ֡лļ
+		if (item.keyframe) {
+			const OutputStream& key = m_streams[output_index];
+			int64_t ts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+			double time_sec = ts != AV_NOPTS_VALUE ? ts * av_q2d(key.time_base) : m_segment_start;
+			bool rotate = m_output && (item.discontinuity ||
+				(m_segment_sec > 0.0 && time_sec - m_segment_start >= m_segment_sec));
+			if (!m_output || rotate) {
+				closeSegment();
+				if (openSegment(ts != AV_NOPTS_VALUE ? av_rescale_q(ts, key.time_base, AV_TIME_BASE_Q) : 0)) {
+					m_segment_start = time_sec;
+				}
+			}
+		}
+
+		if (m_output && output_index < m_streams.size()) {
+			writePacket(packet, m_streams[output_index], output_index);
+		}
+		av_packet_free(&packet);
+	}
+
+	closeSegment();
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_writer_done = true;
+	}
+	cout << "StreamRecorder: Writer finished." << endl;
+}
+
+bool StreamRecorder::openSegment(int64_t start_ts) {
+	uint64_t number = 0;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		number = m_stats.segments + 1;
+	}
+	char suffix[16] = { 0 };
+	snprintf(suffix, sizeof(suffix), "_%03llu", static_cast<unsigned long long>(number));
+	string extension = m_format == "matroska" ? ".mkv" : "." + m_format;
+	string filename = m_file_stem + suffix + extension;
+
+	int ret = avformat_alloc_output_context2(&m_output, nullptr, m_format.c_str(), filename.c_str());
+	if (ret < 0 || !m_output) {
+		cerr << "StreamRecorder Error: Could not create output context for " << filename << "." << endl;
+		m_output = nullptr;
+		return false;
+	}
+
+	for (size_t i = 0; i < m_streams.size(); ++i) {
+		AVStream* st = avformat_new_stream(m_output, nullptr);
+		if (!st || avcodec_parameters_copy(st->codecpar, m_streams[i].codecpar) < 0) {
+			cerr << "StreamRecorder Error: Could not create output stream." << endl;
+			avformat_free_context(m_output);
+			m_output = nullptr;
+			return false;
+		}
+		//  codec tag ϵܲͬ ( FLV -> MP4)ѡ
+		st->codecpar->codec_tag = 0;
+		st->time_base = m_streams[i].time_base;
+		// ԷֶΪ 0·ȥͬһʱ̶Ӧʱ
+		m_ts_offsets[i] = av_rescale_q(start_ts, AV_TIME_BASE_Q, m_streams[i].time_base);
+	}
+
+	if (!(m_output->oformat->flags & AVFMT_NOFILE)) {
+		ret = avio_open(&m_output->pb, filename.c_str(), AVIO_FLAG_WRITE);
+		if (ret < 0) {
+			char errbuf[AV_ERROR_MAX_STRING_SIZE];
+			av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, ret);
+			cerr << "StreamRecorder Error: Could not open " << filename << ": " << errbuf << endl;
+			avformat_free_context(m_output);
+			m_output = nullptr;
+			return false;
+		}
+	}
+
+	// ͷƵƵؼ֡ƽƵǸ
+	m_output->avoid_negative_ts = AVFMT_AVOID_NEG_TS_MAKE_ZERO;
+	AVDictionary* opts = nullptr;
+	if (m_format == "mp4") {
+		// Ƭ MP4쳣˳ʱдĲԿɲ
+		av_dict_set(&opts, "movflags", "frag_keyframe+empty_moov+default_base_moof", 0);
+	}
+	ret = avformat_write_header(m_output, &opts);
+	av_dict_free(&opts);
+	if (ret < 0) {
+		char errbuf[AV_ERROR_MAX_STRING_SIZE];
+		av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, ret);
+		cerr << "StreamRecorder Error: Could not write header for " << filename << ": " << errbuf << endl;
+		if (!(m_output->oformat->flags & AVFMT_NOFILE)) {
+			avio_closep(&m_output->pb);
+		}
+		avformat_free_context(m_output);
+		m_output = nullptr;
+		return false;
+	}
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_stats.segments = number;
+		m_stats.current_file = filename;
+	}
+	m_write_error_logged = false;
+	cout << "StreamRecorder: Started segment " << filename << "." << endl;
+	return true;
+}
+
+void StreamRecorder::closeSegment() {
+	if (!m_output) return;
+
+	av_write_trailer(m_output);
+	if (!(m_output->oformat->flags & AVFMT_NOFILE)) {
+		avio_closep(&m_output->pb);
+	}
+	avformat_free_context(m_output);
+	m_output = nullptr;
+	cout << "StreamRecorder: Segment closed." << endl;
+}
+
+void StreamRecorder::writePacket(AVPacket* packet, const OutputStream& stream, size_t output_index) {
+	// Ҫ DTSʵʱȱʧʱ PTS 棬߶ûеİ޷д
+	if (packet->dts == AV_NOPTS_VALUE) {
+		packet->dts = packet->pts;
+	}
+	if (packet->dts == AV_NOPTS_VALUE) {
+		return;
+	}
+	if (packet->pts != AV_NOPTS_VALUE) {
+		packet->pts -= m_ts_offsets[output_index];
+	}
+	packet->dts -= m_ts_offsets[output_index];
+
+	AVStream* out = m_output->streams[output_index];
+	av_packet_rescale_ts(packet, stream.time_base, out->time_base);
+	packet->stream_index = static_cast<int>(output_index);
+	packet->pos = -1;
+
+	size_t size = static_cast<size_t>(packet->size);
+	// д packet е av_interleaved_write_frame ӹ
+	int ret = av_interleaved_write_frame(m_output, packet);
+	if (ret < 0) {
+		if (!m_write_error_logged) {
+			char errbuf[AV_ERROR_MAX_STRING_SIZE];
+			av_make_error_string(errbuf, AV_ERROR_MAX_STRING_SIZE, ret);
+			cerr << "StreamRecorder Warning: Failed to write packet: " << errbuf << endl;
+			m_write_error_logged = true;
+		}
+		return;
+	}
+
+	lock_guard<mutex> lock(m_mutex);
+	m_stats.packets_written++;
+	m_stats.bytes_written += size;
+}
+
+void StreamRecorder::joinWriter() {
+	if (m_thread.joinable()) {
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_stats.recording = false;
+			m_stop = true;
+		}
+		m_cond.notify_all();
+		m_thread.join();
+	}
+	for (OutputStream& s : m_streams) {
+		avcodec_parameters_free(&s.codecpar);
+	}
+	m_streams.clear();
+}
@@ -0,0 +1,190 @@
+/*
+ * SDLplayerCore - An audio and video player.
+ * Copyright (C) 2025 Kovey <zzwaaa0396@qq.com>
+ *
+ * This file is part of SDLplayerCore.
+ *
+ * SDLplayerCore is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "../include/TimeshiftBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+TimeshiftBuffer::TimeshiftBuffer(double max_duration_sec, size_t max_bytes)
+	: m_max_duration_sec(max_duration_sec), m_max_bytes(max_bytes) {
+}
+
+TimeshiftBuffer::~TimeshiftBuffer() {
+	clear();
+	for (AVPacket*& packet : m_spare) {
+		av_packet_free(&packet);
+	}
+	m_spare.clear();
+}
+
+bool TimeshiftBuffer::append(const AVPacket* packet, double time_sec, bool keyframe) {
+	if (!packet) return false;
+	if (keyframe) {
+		m_skip_to_keyframe = false;
+	}
+	else if (m_skip_to_keyframe) {
+		return false;
+	}
+
+	AVPacket* copy = nullptr;
+	if (!m_spare.empty()) {
+		copy = m_spare.back();
+		m_spare.pop_back();
+	}
+	else {
+		copy = av_packet_alloc();
+		if (!copy) return false;
+	}
+	// ֻüŶеİ뻺еİͬһ
+	if (av_packet_ref(copy, packet) < 0) {
+		m_spare.push_back(copy);
+		return false;
+	}
+
+	if (std::isnan(time_sec)) {
+		time_sec = m_last_time;
+	}
+	m_last_time = time_sec;
+
+	uint64_t seq = m_first_seq + m_entries.size();
+	m_entries.push_back(Entry{ copy, time_sec, keyframe });
+	m_bytes += static_cast<size_t>(copy->size);
+	if (keyframe) {
+		m_keyframes.push_back(seq);
+	}
+
+	evict();
+	return true;
+}
+
+int TimeshiftBuffer::peekStreamIndex() const {
+	if (!hasPending()) return -1;
+	return entryAt(m_cursor).packet->stream_index;
+}
+
+bool TimeshiftBuffer::read(AVPacket* packet) {
+	if (!packet || !hasPending()) return false;
+	av_packet_unref(packet);
+	if (av_packet_ref(packet, entryAt(m_cursor).packet) < 0) {
+		return false;
+	}
+	m_cursor++;
+	return true;
+}
+
+double TimeshiftBuffer::seek(double time_sec) {
+	if (m_keyframes.empty()) return std::nan("");
+
+	// ؼ֡ʱҵһĿĹؼ֡ȡǰһ
+	auto it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), time_sec,
+		[this](double t, uint64_t seq) { return t < entryAt(seq).time; });
+	size_t index = (it == m_keyframes.begin()) ? 0 : static_cast<size_t>(it - m_keyframes.begin()) - 1;
+	return moveCursorToKeyframe(index);
+}
+
+double TimeshiftBuffer::seekToLatestKeyframe() {
+	if (m_keyframes.empty()) return std::nan("");
+	return moveCursorToKeyframe(m_keyframes.size() - 1);
+}
+
+bool TimeshiftBuffer::takeOverrun() {
+	bool overrun = m_overrun;
+	m_overrun = false;
+	return overrun;
+}
+
+double TimeshiftBuffer::getStartTime() const {
+	return m_entries.empty() ? std::nan("") : m_entries.front().time;
+}
+
+double TimeshiftBuffer::getEndTime() const {
+	return m_entries.empty() ? std::nan("") : m_entries.back().time;
+}
+
+double TimeshiftBuffer::getDuration() const {
+	if (m_entries.empty()) return 0.0;
+	return std::max(0.0, m_entries.back().time - m_entries.front().time);
+}
+
+void TimeshiftBuffer::clear() {
+	while (!m_entries.empty()) {
+		popFront();
+	}
+	m_keyframes.clear();
+	m_cursor = m_first_seq;
+	m_overrun = false;
+	m_skip_to_keyframe = false;
+}
+
+void TimeshiftBuffer::popFront() {
+	Entry& front = m_entries.front();
+	m_bytes -= static_cast<size_t>(front.packet->size);
+	av_packet_unref(front.packet);
+	m_spare.push_back(front.packet);
+	m_entries.pop_front();
+	m_first_seq++;
+}
+
+void TimeshiftBuffer::evict() {
+	while (!m_entries.empty() && (getDuration() > m_max_duration_sec || m_bytes > m_max_bytes)) {
+		// һΰ̭ͷݣ̭һؼ֡
+		if (!m_keyframes.empty() && m_keyframes.front() > m_first_seq) {
+			while (m_first_seq < m_keyframes.front()) {
+				popFront();
+			}
+			continue;
+		}
+		// ̭ɵ GOP
+		if (m_keyframes.size() >= 2) {
+			uint64_t next_keyframe = m_keyframes[1];
+			while (m_first_seq < next_keyframe) {
+				popFront();
+			}
+			m_keyframes.pop_front();
+			continue;
+		}
+
+		// ûһؼ֡ (ֻһ GOP intra-refresh / ֻ CRA һ IDR û)
+		// ֻʱʱһؼ̭֡
+		if (!m_keyframes.empty()) {
+			// Ψһ GOP дֱԵ̭ôգ
+			// ֽڳʱΪ֮ķǹؼ֡ (¼һ)
+			if (m_bytes > m_max_bytes) {
+				m_skip_to_keyframe = true;
+			}
+			break;
+		}
+		// ûйؼ̭֡
+		popFront();
+		// ̭Խαʱ· m_overrunαδӰ (ֱԵ) ʱϲ
+	}
+
+	if (m_cursor < m_first_seq) {
+		// ǰԽα꣺α䵽ڵĵһؼ֡ (ûйؼ֡ʱ䵽)
+		m_cursor = m_keyframes.empty() ? m_first_seq : m_keyframes.front();
+		m_overrun = true;
+	}
+}
+
+double TimeshiftBuffer::moveCursorToKeyframe(size_t index) {
+	uint64_t seq = m_keyframes[index];
+	m_cursor = seq;
+	return entryAt(seq).time;
+}
@@ -24,8 +24,10 @@
 #include <memory>
 #include <vector>
 #include <limits> // std::numeric_limits
+#include <cstdlib> // std::atof
 
 #include "../include/MediaPlayer.h"
+#include "../include/DecoderBenchmark.h"
 
 /**
 * @brief 在程序退出前暂停，等待用户输入，防止控制台窗口闪退
@@ -64,9 +66,42 @@ void remove_all_quotes(std::string& path) {
     }
 }
 
+/**
+ * @brief 解码基准模式：SDLPlayer --bench-decode <文件> [秒数]
+ * 以不同的线程配置解码文件开头一段视频，输出每种配置的吞吐与延迟，不打开窗口和音频设备
+ */
+int run_decode_benchmark(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " --bench-decode <media file> [seconds]" << std::endl;
+        return 1;
+    }
+    std::string filepath = argv[2];
+    remove_all_quotes(filepath);
+    double seconds = argc >= 4 ? std::atof(argv[3]) : 30.0;
+    if (seconds <= 0.0) {
+        seconds = 30.0;
+    }
+
+    DecoderBenchmark benchmark(filepath, seconds);
+    if (!benchmark.load()) {
+        return 1;
+    }
+    std::vector<DecoderBenchmarkResult> results;
+    for (const DecoderBenchmarkCase& test_case : DecoderBenchmark::defaultCases()) {
+        std::cout << "DecoderBenchmark: Running \"" << test_case.label << "\"..." << std::endl;
+        results.push_back(benchmark.run(test_case));
+    }
+    benchmark.printReport(results, std::cout);
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     std::string filepath;
 
+    if (argc >= 2 && std::string(argv[1]) == "--bench-decode") {
+        return run_decode_benchmark(argc, argv);
+    }
+
     // 1. & 2. 获取并清理路径
     if (argc >= 2) {
         filepath = argv[1];